@@ -2,18 +2,21 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <stdarg.h>
 #include <stdio.h>
 
 #include "device/device.h"
 #include "scene/camera.h"
 #include "scene/integrator.h"
 #include "scene/scene.h"
+#include "scene/stats.h"
 #include "session/buffers.h"
 #include "session/session.h"
 
 #include "util/args.h"
 #include "util/foreach.h"
 #include "util/function.h"
+#include "util/hash.h"
 #include "util/image.h"
 #include "util/log.h"
 #include "util/path.h"
@@ -49,6 +52,10 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  string profile_filepath;
+  bool daemon;
+  int frame;
+  int seed;
 } options;
 
 static void session_print(const string &str)
@@ -97,7 +104,7 @@ static BufferParams &session_buffer_params()
   return buffer_params;
 }
 
-static void scene_init()
+static bool scene_init()
 {
   options.scene = options.session->scene;
 
@@ -109,7 +116,9 @@ static void scene_init()
   else
 #endif
   {
-    xml_read_file(options.scene, options.filepath.c_str());
+    if (!xml_read_file(options.scene, options.filepath.c_str())) {
+      return false;
+    }
   }
 
   /* Camera width/height override? */
@@ -124,6 +133,8 @@ static void scene_init()
 
   /* Calculate Viewplane */
   options.scene->camera->compute_auto_viewplane();
+
+  return true;
 }
 
 static void session_init()
@@ -152,7 +163,9 @@ static void session_init()
 #endif
 
   /* load scene */
-  scene_init();
+  if (!scene_init()) {
+    exit(EXIT_FAILURE);
+  }
 
   /* add pass for output. */
   Pass *pass = options.scene->create_node<Pass>();
@@ -163,9 +176,24 @@ static void session_init()
   options.session->start();
 }
 
+static void session_write_profile()
+{
+  RenderStats stats;
+  options.session->collect_statistics(&stats);
+
+  string report = stats.profiling_json_report();
+  if (!path_write_text(options.profile_filepath, report)) {
+    fprintf(stderr, "Failed to write profile to %s\n", options.profile_filepath.c_str());
+  }
+}
+
 static void session_exit()
 {
   if (options.session) {
+    if (!options.profile_filepath.empty()) {
+      session_write_profile();
+    }
+
     delete options.session;
     options.session = NULL;
   }
@@ -348,6 +376,226 @@ static void keyboard(unsigned char key)
 }
 #endif
 
+/* Daemon
+ *
+ * Keeps the session alive and reads jobs from stdin, one command per line, so that the scene,
+ * BVH and images are reused between renders. Every command is answered with a line starting
+ * with "ok" or "error". Only the parts of the scene which are edited are updated for the next
+ * render. */
+
+static void daemon_reply(const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+
+  printf("\n");
+  fflush(stdout);
+}
+
+/* Output file path for the current frame, with a sequence of # replaced by the zero padded
+ * frame number. */
+static string daemon_output_filepath()
+{
+  string filepath = options.output_filepath;
+
+  const size_t start = filepath.find('#');
+  if (start == string::npos) {
+    return filepath;
+  }
+
+  size_t end = start;
+  while (end < filepath.size() && filepath[end] == '#') {
+    end++;
+  }
+
+  const string frame = string_printf("%0*d", int(end - start), options.frame);
+  return filepath.substr(0, start) + frame + filepath.substr(end);
+}
+
+static void daemon_session_exit()
+{
+  if (options.session) {
+    delete options.session;
+    options.session = NULL;
+    options.scene = NULL;
+  }
+}
+
+static bool daemon_load(const string &filepath)
+{
+  if (!path_exists(filepath)) {
+    daemon_reply("error file not found: %s", filepath.c_str());
+    return false;
+  }
+
+  /* A new scene needs a new session, nothing can be reused. */
+  daemon_session_exit();
+
+  options.filepath = filepath;
+  options.output_pass = "combined";
+  options.session = new Session(options.session_params, options.scene_params);
+
+  if (!scene_init()) {
+    daemon_session_exit();
+    daemon_reply("error failed to read scene: %s", filepath.c_str());
+    return false;
+  }
+
+  Pass *pass = options.scene->create_node<Pass>();
+  pass->set_name(ustring(options.output_pass.c_str()));
+  pass->set_type(PASS_COMBINED);
+
+  options.seed = options.scene->integrator->get_seed();
+
+  return true;
+}
+
+static void daemon_update_resolution()
+{
+  Camera *cam = options.scene->camera;
+  cam->set_full_width(options.width);
+  cam->set_full_height(options.height);
+  cam->compute_auto_viewplane();
+  cam->need_flags_update = true;
+  cam->need_device_update = true;
+}
+
+static bool daemon_render()
+{
+  if (options.output_filepath.empty()) {
+    daemon_reply("error no output file path");
+    return false;
+  }
+
+  Session *session = options.session;
+  const string filepath = daemon_output_filepath();
+
+  session->set_output_driver(
+      make_unique<OIIOOutputDriver>(filepath, options.output_pass, [](const string &) {}));
+
+  session->progress.reset();
+  session->stats.mem_peak = session->stats.mem_used;
+
+  const double time_start = time_dt();
+
+  session->reset(options.session_params, session_buffer_params());
+  session->start();
+  session->wait();
+
+  if (session->progress.get_error()) {
+    daemon_reply("error %s", session->progress.get_error_message().c_str());
+    return false;
+  }
+
+  daemon_reply("ok rendered %s in %.2f seconds", filepath.c_str(), time_dt() - time_start);
+  return true;
+}
+
+static void daemon_main_loop()
+{
+  if (!options.filepath.empty() && daemon_load(options.filepath)) {
+    daemon_reply("ok loaded %s", options.filepath.c_str());
+  }
+
+  string line;
+  char buffer[4096];
+
+  while (fgets(buffer, sizeof(buffer), stdin)) {
+    /* Lines longer than the buffer are read in parts. */
+    line += buffer;
+    if (line.empty() || (line.back() != '\n' && !feof(stdin))) {
+      continue;
+    }
+
+    line = string_strip(line);
+    const size_t separator = line.find(' ');
+    const string command = line.substr(0, separator);
+    const string arguments = (separator == string::npos) ? "" :
+                                                           string_strip(line.substr(separator));
+    line.clear();
+
+    if (command.empty() || command[0] == '#') {
+      continue;
+    }
+    else if (command == "quit") {
+      daemon_reply("ok");
+      break;
+    }
+    else if (command == "load") {
+      if (daemon_load(arguments)) {
+        daemon_reply("ok loaded %s", arguments.c_str());
+      }
+    }
+    else if (command == "output") {
+      options.output_filepath = arguments;
+      daemon_reply("ok");
+    }
+    else if (command == "samples") {
+      const int samples = atoi(arguments.c_str());
+      if (samples <= 0) {
+        daemon_reply("error invalid number of samples: %s", arguments.c_str());
+        continue;
+      }
+      options.session_params.samples = samples;
+      daemon_reply("ok");
+    }
+    else if (!options.session) {
+      daemon_reply("error no scene loaded");
+    }
+    else if (command == "resolution") {
+      int width = 0, height = 0;
+      if (sscanf(arguments.c_str(), "%d %d", &width, &height) != 2 || width <= 0 || height <= 0)
+      {
+        daemon_reply("error invalid resolution: %s", arguments.c_str());
+        continue;
+      }
+      options.width = width;
+      options.height = height;
+      {
+        thread_scoped_lock scene_lock(options.scene->mutex);
+        daemon_update_resolution();
+      }
+      daemon_reply("ok");
+    }
+    else if (command == "frame") {
+      /* Decorrelate noise between frames, like the animated seed in Blender. */
+      options.frame = atoi(arguments.c_str());
+      {
+        thread_scoped_lock scene_lock(options.scene->mutex);
+        options.scene->integrator->set_seed(hash_uint2(options.frame, options.seed));
+      }
+      daemon_reply("ok");
+    }
+    else if (command == "xml") {
+      /* The session thread of the previous render is still alive, lock the scene for edits. */
+      thread_scoped_lock scene_lock(options.scene->mutex);
+      if (!xml_read_string(
+              options.scene, arguments.c_str(), path_dirname(options.filepath).c_str()))
+      {
+        daemon_reply("error invalid XML");
+        continue;
+      }
+      /* Reading the camera resets the resolution, keep the one of the daemon. */
+      daemon_update_resolution();
+      daemon_reply("ok");
+    }
+    else if (command == "render") {
+      daemon_render();
+    }
+    else {
+      daemon_reply("error unknown command: %s", command.c_str());
+    }
+  }
+
+  if (options.session && !options.profile_filepath.empty()) {
+    session_write_profile();
+  }
+
+  daemon_session_exit();
+}
+
 static int files_parse(int argc, const char *argv[])
 {
   if (argc > 0) {
@@ -364,6 +612,9 @@ static void options_parse(int argc, const char **argv)
   options.filepath = "";
   options.session = NULL;
   options.quiet = false;
+  options.daemon = false;
+  options.frame = 0;
+  options.seed = 0;
   options.session_params.use_auto_tile = false;
   options.session_params.tile_size = 0;
 
@@ -408,6 +659,11 @@ static void options_parse(int argc, const char **argv)
              "--quiet",
              &options.quiet,
              "In background mode, don't print progress messages",
+             "--daemon",
+             &options.daemon,
+             "Keep running and read render jobs from stdin, one command per line: load <file>, "
+             "xml <elements>, output <file>, samples <n>, resolution <width> <height>, "
+             "frame <n>, render, quit",
              "--samples %d",
              &options.session_params.samples,
              "Number of samples to render",
@@ -426,12 +682,19 @@ static void options_parse(int argc, const char **argv)
              "--tile-size %d",
              &options.session_params.tile_size,
              "Tile size in pixels",
+             "--half-tile-passes",
+             &options.session_params.use_half_float_tile_passes,
+             "Write smaller tile files, storing data passes as half floats",
              "--list-devices",
              &list,
              "List information about all available devices",
              "--profile",
              &profile,
              "Enable profile logging",
+             "--profile-json %s",
+             &options.profile_filepath,
+             "Enable profiling and write time per kernel stage, shader, object and light as JSON "
+             "to the file path (CPU only)",
 #ifdef WITH_CYCLES_LOGGING
              "--debug",
              &debug,
@@ -476,12 +739,12 @@ static void options_parse(int argc, const char **argv)
     printf("%s\n", CYCLES_VERSION_STRING);
     exit(EXIT_SUCCESS);
   }
-  else if (help || options.filepath == "") {
+  else if (help || (options.filepath == "" && !options.daemon)) {
     ap.usage();
     exit(EXIT_SUCCESS);
   }
 
-  options.session_params.use_profiling = profile;
+  options.session_params.use_profiling = profile || !options.profile_filepath.empty();
 
   if (ssname == "osl") {
     options.scene_params.shadingsystem = SHADINGSYSTEM_OSL;
@@ -494,6 +757,8 @@ static void options_parse(int argc, const char **argv)
   options.session_params.background = true;
 #endif
 
+  options.scene_params.use_light_tree_refit = !options.session_params.background;
+
   if (options.session_params.tile_size > 0) {
     options.session_params.use_auto_tile = true;
   }
@@ -529,7 +794,7 @@ static void options_parse(int argc, const char **argv)
     fprintf(stderr, "Invalid number of samples: %d\n", options.session_params.samples);
     exit(EXIT_FAILURE);
   }
-  else if (options.filepath == "") {
+  else if (options.filepath == "" && !options.daemon) {
     fprintf(stderr, "No file path specified\n");
     exit(EXIT_FAILURE);
   }
@@ -545,6 +810,12 @@ int main(int argc, const char **argv)
   path_init();
   options_parse(argc, argv);
 
+  if (options.daemon) {
+    options.session_params.background = true;
+    daemon_main_loop();
+    return 0;
+  }
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
@@ -763,10 +763,12 @@ static void xml_read_object(XMLReadState &state, xml_node node)
 
 /* Scene */
 
-static void xml_read_include(XMLReadState &state, const string &src);
+static bool xml_read_include(XMLReadState &state, const string &src);
 
-static void xml_read_scene(XMLReadState &state, xml_node scene_node)
+static bool xml_read_scene(XMLReadState &state, xml_node scene_node)
 {
+  bool success = true;
+
   for (xml_node node = scene_node.first_child(); node; node = node.next_sibling()) {
     if (string_iequals(node.name(), "film")) {
       xml_read_node(state, state.scene->film, node);
@@ -793,26 +795,26 @@ static void xml_read_scene(XMLReadState &state, xml_node scene_node)
       XMLReadState substate = state;
 
       xml_read_transform(node, substate.tfm);
-      xml_read_scene(substate, node);
+      success &= xml_read_scene(substate, node);
     }
     else if (string_iequals(node.name(), "state")) {
       XMLReadState substate = state;
 
       xml_read_state(substate, node);
-      xml_read_scene(substate, node);
+      success &= xml_read_scene(substate, node);
     }
     else if (string_iequals(node.name(), "include")) {
       string src;
 
       if (xml_read_string(&src, node, "src")) {
-        xml_read_include(state, src);
+        success &= xml_read_include(state, src);
       }
     }
     else if (string_iequals(node.name(), "object")) {
       XMLReadState substate = state;
 
       xml_read_object(substate, node);
-      xml_read_scene(substate, node);
+      success &= xml_read_scene(substate, node);
     }
 #ifdef WITH_ALEMBIC
     else if (string_iequals(node.name(), "alembic")) {
@@ -823,11 +825,13 @@ static void xml_read_scene(XMLReadState &state, xml_node scene_node)
       fprintf(stderr, "Unknown node \"%s\".\n", node.name());
     }
   }
+
+  return success;
 }
 
 /* Include */
 
-static void xml_read_include(XMLReadState &state, const string &src)
+static bool xml_read_include(XMLReadState &state, const string &src)
 {
   /* open XML document */
   xml_document doc;
@@ -841,17 +845,16 @@ static void xml_read_include(XMLReadState &state, const string &src)
     substate.base = path_dirname(path);
 
     xml_node cycles = doc.child("cycles");
-    xml_read_scene(substate, cycles);
-  }
-  else {
-    fprintf(stderr, "%s read error: %s\n", src.c_str(), parse_result.description());
-    exit(EXIT_FAILURE);
+    return xml_read_scene(substate, cycles);
   }
+
+  fprintf(stderr, "%s read error: %s\n", src.c_str(), parse_result.description());
+  return false;
 }
 
 /* File */
 
-void xml_read_file(Scene *scene, const char *filepath)
+bool xml_read_file(Scene *scene, const char *filepath)
 {
   XMLReadState state;
 
@@ -862,9 +865,35 @@ void xml_read_file(Scene *scene, const char *filepath)
   state.dicing_rate = 1.0f;
   state.base = path_dirname(filepath);
 
-  xml_read_include(state, path_filename(filepath));
+  const bool success = xml_read_include(state, path_filename(filepath));
 
   scene->params.bvh_type = BVH_TYPE_STATIC;
+
+  return success;
+}
+
+bool xml_read_string(Scene *scene, const char *xml, const char *base_path)
+{
+  xml_document doc;
+  xml_parse_result parse_result = doc.load_string(xml);
+
+  if (!parse_result) {
+    fprintf(stderr, "XML read error: %s\n", parse_result.description());
+    return false;
+  }
+
+  XMLReadState state;
+
+  state.scene = scene;
+  state.tfm = transform_identity();
+  state.shader = scene->default_surface;
+  state.smooth = false;
+  state.dicing_rate = 1.0f;
+  state.base = base_path;
+
+  /* Elements may be wrapped in a cycles element like in files, or given directly. */
+  xml_node cycles = doc.child("cycles");
+  return xml_read_scene(state, cycles ? cycles : doc.root());
 }
 
 CCL_NAMESPACE_END
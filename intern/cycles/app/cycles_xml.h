@@ -9,7 +9,14 @@ CCL_NAMESPACE_BEGIN
 
 class Scene;
 
-void xml_read_file(Scene *scene, const char *filepath);
+/* Read a scene from an XML file. Returns false if the file or one of its includes can not be
+ * parsed, in which case the scene may be partially read. */
+bool xml_read_file(Scene *scene, const char *filepath);
+
+/* Read scene elements from an XML string into an existing scene, to edit it between renders.
+ * Included files are relative to base_path. Returns false if the string or one of its includes
+ * can not be parsed. */
+bool xml_read_string(Scene *scene, const char *xml, const char *base_path);
 
 /* macros for importing */
 #define RAD2DEGF(_rad) ((_rad) * (float)(180.0 / M_PI))
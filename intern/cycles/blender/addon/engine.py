@@ -215,6 +215,8 @@ def list_render_passes(scene, srl):
     # Debug passes.
     if crl.pass_debug_sample_count:
         yield ("Debug Sample Count", "X", 'VALUE')
+    if crl.pass_debug_render_time:
+        yield ("Debug Render Time", "X", 'VALUE')
 
     # Cryptomatte passes.
     # NOTE: Name channels are lowercase RGBA so that compression rules check in OpenEXR DWA code
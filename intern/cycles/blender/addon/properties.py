@@ -788,6 +788,14 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=2, max=65536
     )
 
+    use_volume_delta_tracking: BoolProperty(
+        name="Delta Tracking",
+        description="Render volume objects with density grids by sampling collisions against a coarse "
+        "grid bounding their density, instead of stepping through them. Unbiased, and faster for "
+        "large sparse volumes since empty and thin regions are skipped",
+        default=False,
+    )
+
     dicing_rate: FloatProperty(
         name="Dicing Rate",
         description="Size of a micropolygon in pixels",
@@ -1001,6 +1009,20 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Load image textures on demand from a tiled and mipmapped cache, instead of fully into memory. "
+                    "Memory usage scales with the parts of images that are seen. Only supported on the CPU",
+        default=False,
+    )
+
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache in megabytes",
+        min=64, max=1048576,
+        default=4096,
+    )
+
     use_fast_gi: BoolProperty(
         name="Fast GI Approximation",
         description="Approximate diffuse indirect light with background tinted ambient occlusion. "
@@ -1040,6 +1062,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="",
         min=8, max=8192,
     )
+    use_half_float_tile_passes: BoolProperty(
+        name="Smaller Tile Files",
+        description="Store normal, roughness and denoising data passes with half float precision in the tiles cached to disk, "
+        "reducing disk usage and the time spent writing tiles. Memory usage of the render is not affected",
+        default=False,
+    )
 
     # Various fine-tuning debug flags
 
@@ -1049,12 +1077,23 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         return _cycles.debug_flags_update(scene)
 
     debug_use_cpu_avx2: BoolProperty(name="AVX2", default=True)
+    debug_use_cpu_avx512: BoolProperty(name="AVX-512", default=True)
     debug_use_cpu_sse42: BoolProperty(name="SSE42", default=True)
     debug_bvh_layout: EnumProperty(
         name="BVH Layout",
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Render batches of paths one kernel at a time, sorted by shader, instead of each path to completion. Can be faster for scenes with many complex shaders",
+        default=False,
+    )
+    debug_use_cpu_ray_packets: BoolProperty(
+        name="Ray Packets",
+        description="In wavefront mode, intersect coherent camera and shadow rays together in packets",
+        default=True,
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
 
@@ -1444,6 +1483,13 @@ class CyclesRenderLayerSettings(bpy.types.PropertyGroup):
         default=False,
         update=update_render_passes,
     )
+    pass_debug_render_time: BoolProperty(
+        name="Debug Render Time",
+        description="Average time in milliseconds to render a sample of the pixel. To find expensive parts of the image, "
+        "only available for CPU rendering",
+        default=False,
+        update=update_render_passes,
+    )
     use_pass_volume_direct: BoolProperty(
         name="Volume Direct",
         description="Deliver direct volumetric scattering pass",
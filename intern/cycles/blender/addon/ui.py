@@ -552,6 +552,7 @@ class CYCLES_RENDER_PT_volumes(CyclesButtonsPanel, Panel):
         col.prop(cscene, "volume_preview_step_rate", text="Viewport")
 
         layout.prop(cscene, "volume_max_steps", text="Max Steps")
+        layout.prop(cscene, "use_volume_delta_tracking")
 
 
 class CYCLES_RENDER_PT_light_paths(CyclesButtonsPanel, Panel):
@@ -835,6 +836,14 @@ class CYCLES_RENDER_PT_performance_memory(CyclesButtonsPanel, Panel):
         sub = col.column()
         sub.active = cscene.use_auto_tile
         sub.prop(cscene, "tile_size")
+        sub.prop(cscene, "use_half_float_tile_passes")
+
+        col = layout.column()
+        col.active = use_cpu(context)
+        col.prop(cscene, "use_texture_cache")
+        sub = col.column()
+        sub.active = cscene.use_texture_cache
+        sub.prop(cscene, "texture_cache_size")
 
 
 class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Panel):
@@ -1008,6 +1017,7 @@ class CYCLES_RENDER_PT_passes_data(CyclesButtonsPanel, Panel):
 
         col = layout.column(heading="Debug", align=True)
         col.prop(cycles_view_layer, "pass_debug_sample_count", text="Sample Count")
+        col.prop(cycles_view_layer, "pass_debug_render_time", text="Render Time")
 
         layout.prop(view_layer, "pass_alpha_threshold")
 
@@ -2155,7 +2165,12 @@ class CYCLES_RENDER_PT_debug(CyclesDebugButtonsPanel, Panel):
         row = col.row(align=True)
         row.prop(cscene, "debug_use_cpu_sse42", toggle=True)
         row.prop(cscene, "debug_use_cpu_avx2", toggle=True)
+        row.prop(cscene, "debug_use_cpu_avx512", toggle=True)
         col.prop(cscene, "debug_bvh_layout", text="BVH")
+        col.prop(cscene, "debug_use_cpu_wavefront")
+        sub = col.column()
+        sub.active = cscene.debug_use_cpu_wavefront
+        sub.prop(cscene, "debug_use_cpu_ray_packets")
 
         col.separator()
 
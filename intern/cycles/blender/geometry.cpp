@@ -13,7 +13,11 @@
 #include "blender/util.h"
 
 #include "util/foreach.h"
+#include "util/log.h"
+#include "util/md5.h"
 #include "util/task.h"
+#include "util/tbb.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -81,9 +85,6 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
                         b_ob_info.object_data;
   GeometryKey key(b_key_id.ptr.data, geom_type);
 
-  /* Find shader indices. */
-  array<Node *> used_shaders = find_used_shaders(b_ob_info.iter_object);
-
   /* Ensure we only sync instanced geometry once. */
   Geometry *geom = geometry_map.find(key);
   if (geom) {
@@ -92,6 +93,9 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
     }
   }
 
+  /* Find shader indices. */
+  array<Node *> used_shaders = find_used_shaders(b_ob_info.iter_object);
+
   /* Test if we need to sync. */
   bool sync = true;
   if (geom == NULL) {
@@ -113,6 +117,11 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
   else {
     /* Test if we need to update existing geometry. */
     sync = geometry_map.update(geom, b_key_id);
+
+    /* The data of deduplicated geometry was cleared, export it again. */
+    if (geometry_duplicates.erase(geom)) {
+      sync = true;
+    }
   }
 
   if (!sync) {
@@ -186,6 +195,172 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
   return geom;
 }
 
+bool BlenderSync::geometry_is_updated(Geometry *geom)
+{
+  /* Geometry synced in this update may still be modified by a task of the geometry task pool, so
+   * don't read its flags. Other geometry is not touched by the tasks. */
+  if (geometry_synced.find(geom) != geometry_synced.end()) {
+    return true;
+  }
+  return geom->is_modified();
+}
+
+/* Hash attribute names and types, and either their data or only its size. */
+static void attribute_set_hash(const AttributeSet &attributes, MD5Hash &md5, const bool use_data)
+{
+  foreach (const Attribute &attr, attributes.attributes) {
+    md5.append(attr.name.string());
+    md5.append((const uint8_t *)&attr.std, sizeof(attr.std));
+    md5.append((const uint8_t *)&attr.element, sizeof(attr.element));
+    md5.append((const uint8_t *)&attr.flags, sizeof(attr.flags));
+    md5.append(string(attr.type.c_str()));
+
+    if (!use_data) {
+      const size_t size = attr.buffer.size();
+      md5.append((const uint8_t *)&size, sizeof(size));
+      continue;
+    }
+
+    /* Append in chunks, the size is passed as int. */
+    const uint8_t *data = (const uint8_t *)attr.buffer.data();
+    const size_t chunk_size = 1 << 30;
+    for (size_t offset = 0; offset < attr.buffer.size(); offset += chunk_size) {
+      md5.append(data + offset, (int)min(chunk_size, attr.buffer.size() - offset));
+    }
+  }
+}
+
+/* Cheap signature from the element counts, attributes and shaders of the geometry, without
+ * reading its data. Identical geometry has the same signature. */
+static string geometry_signature(Geometry *geom)
+{
+  MD5Hash md5;
+
+  size_t counts[3] = {0, 0, 0};
+  if (geom->is_mesh()) {
+    const Mesh *mesh = static_cast<const Mesh *>(geom);
+    counts[0] = mesh->get_verts().size();
+    counts[1] = mesh->num_triangles();
+    counts[2] = mesh->get_subd_face_corners().size();
+  }
+  else if (geom->is_hair()) {
+    const Hair *hair = static_cast<const Hair *>(geom);
+    counts[0] = hair->num_keys();
+    counts[1] = hair->num_curves();
+  }
+  else if (geom->is_pointcloud()) {
+    const PointCloud *pointcloud = static_cast<const PointCloud *>(geom);
+    counts[0] = pointcloud->num_points();
+  }
+
+  const uint motion_steps = geom->get_use_motion_blur() ? geom->get_motion_steps() : 0;
+  md5.append((const uint8_t *)&geom->geometry_type, sizeof(geom->geometry_type));
+  md5.append((const uint8_t *)counts, sizeof(counts));
+  md5.append((const uint8_t *)&motion_steps, sizeof(motion_steps));
+
+  for (const Node *shader : geom->get_used_shaders()) {
+    md5.append((const uint8_t *)&shader, sizeof(shader));
+  }
+
+  attribute_set_hash(geom->attributes, md5, false);
+  if (geom->is_mesh()) {
+    const Mesh *mesh = static_cast<const Mesh *>(geom);
+    attribute_set_hash(mesh->subd_attributes, md5, false);
+  }
+
+  return md5.get_hex();
+}
+
+static string geometry_content_hash(Geometry *geom)
+{
+  MD5Hash md5;
+
+  /* Sockets include the geometry type and the used shaders. */
+  geom->hash(md5);
+  attribute_set_hash(geom->attributes, md5, true);
+
+  if (geom->is_mesh()) {
+    Mesh *mesh = static_cast<Mesh *>(geom);
+    attribute_set_hash(mesh->subd_attributes, md5, true);
+  }
+
+  return md5.get_hex();
+}
+
+void BlenderSync::deduplicate_geometry()
+{
+  /* Different Blender data can result in identical geometry, for example linked duplicates that
+   * were made single user, or instances realized by geometry nodes. Objects using such geometry
+   * are changed to share the same geometry, so the BVH is built and the data stored on the
+   * device only once. Duplicates stay in the geometry map with their data cleared.
+   *
+   * This runs after export, so duplicates are still exported. It saves BVH build time and device
+   * memory, not sync time. */
+  vector<Geometry *> geometry;
+  foreach (Geometry *geom, geometry_synced) {
+    /* Volumes keep voxel data in the image manager, which is already shared. */
+    if (geom->is_mesh() || geom->is_hair() || geom->is_pointcloud()) {
+      geometry.push_back(geom);
+    }
+  }
+
+  if (geometry.size() < 2 || progress.get_cancel()) {
+    return;
+  }
+
+  scoped_timer timer;
+
+  /* Only hash the data of geometry that has the same signature as other geometry. */
+  map<string, vector<Geometry *>> signature_groups;
+  foreach (Geometry *geom, geometry) {
+    signature_groups[geometry_signature(geom)].push_back(geom);
+  }
+
+  vector<Geometry *> candidates;
+  for (const auto &group : signature_groups) {
+    if (group.second.size() > 1) {
+      candidates.insert(candidates.end(), group.second.begin(), group.second.end());
+    }
+  }
+
+  if (candidates.empty()) {
+    return;
+  }
+
+  vector<string> hashes(candidates.size());
+  parallel_for(size_t(0), candidates.size(), [&](size_t i) {
+    hashes[i] = geometry_content_hash(candidates[i]);
+  });
+
+  map<string, Geometry *> unique_geometry;
+  map<Geometry *, Geometry *> replacements;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    auto it = unique_geometry.insert(std::make_pair(hashes[i], candidates[i])).first;
+    if (it->second != candidates[i]) {
+      replacements[candidates[i]] = it->second;
+    }
+  }
+
+  if (replacements.empty()) {
+    return;
+  }
+
+  foreach (Object *object, scene->objects) {
+    auto it = replacements.find(object->get_geometry());
+    if (it != replacements.end()) {
+      object->set_geometry(it->second);
+    }
+  }
+
+  for (const auto &replacement : replacements) {
+    replacement.first->clear(true);
+    geometry_duplicates.insert(replacement.first);
+  }
+
+  VLOG_INFO << "Deduplicated " << replacements.size() << " of " << geometry.size()
+            << " geometries in " << timer.get_time() << " seconds";
+}
+
 void BlenderSync::sync_geometry_motion(BL::Depsgraph &b_depsgraph,
                                        BObjectInfo &b_ob_info,
                                        Object *object,
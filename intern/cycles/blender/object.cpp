@@ -243,10 +243,6 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
     return NULL;
   }
 
-  /* Use task pool only for non-instances, since sync_dupli_particle accesses
-   * geometry. This restriction should be removed for better performance. */
-  TaskPool *object_geom_task_pool = (is_instance) ? NULL : geom_task_pool;
-
   /* key to lookup object */
   ObjectKey key(b_parent, persistent_id, b_ob_info.real_object, use_particle_hair);
   Object *object;
@@ -267,7 +263,7 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
       /* mesh deformation */
       if (object->get_geometry()) {
         sync_geometry_motion(
-            b_depsgraph, b_ob_info, object, motion_time, use_particle_hair, object_geom_task_pool);
+            b_depsgraph, b_ob_info, object, motion_time, use_particle_hair, geom_task_pool);
       }
     }
 
@@ -280,7 +276,7 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
 
   /* mesh sync */
   Geometry *geometry = sync_geometry(
-      b_depsgraph, b_ob_info, object_updated, use_particle_hair, object_geom_task_pool);
+      b_depsgraph, b_ob_info, object_updated, use_particle_hair, geom_task_pool);
   object->set_geometry(geometry);
 
   /* special case not tracked by object update flags */
@@ -334,7 +330,7 @@ Object *BlenderSync::sync_object(BL::Depsgraph &b_depsgraph,
    * transform comparison should not be needed, but duplis don't work perfect
    * in the depsgraph and may not signal changes, so this is a workaround */
   if (object->is_modified() || object_updated ||
-      (object->get_geometry() && object->get_geometry()->is_modified()))
+      (object->get_geometry() && geometry_is_updated(object->get_geometry())))
   {
     object->name = b_ob.name().c_str();
     object->set_pass_id(b_ob.pass_index());
@@ -47,7 +47,7 @@ bool BlenderSync::sync_dupli_particle(BL::Object &b_ob,
   bool need_update = particle_system_map.add_or_update(&psys, b_ob, b_instance.object(), key);
 
   /* no update needed? */
-  if (!need_update && !object->get_geometry()->is_modified() &&
+  if (!need_update && !geometry_is_updated(object->get_geometry()) &&
       !scene->object_manager->need_update())
   {
     return true;
@@ -288,6 +288,12 @@ void BlenderSync::sync_data(BL::RenderSettings &b_render,
   }
   sync_motion(b_render, b_depsgraph, b_v3d, b_override, width, height, python_thread_state);
 
+  /* Deduplicated geometry has to be exported again on the next sync, which is only worth it when
+   * the scene is synced once. */
+  if (background && !b_render.use_persistent_data()) {
+    deduplicate_geometry();
+  }
+
   geometry_synced.clear();
 
   /* Shader sync done at the end, since object sync uses it.
@@ -326,6 +332,7 @@ void BlenderSync::sync_integrator(BL::ViewLayer &b_view_layer,
   float volume_step_rate = (preview) ? get_float(cscene, "volume_preview_step_rate") :
                                        get_float(cscene, "volume_step_rate");
   integrator->set_volume_step_rate(volume_step_rate);
+  integrator->set_use_volume_delta_tracking(get_boolean(cscene, "use_volume_delta_tracking"));
 
   integrator->set_caustics_reflective(get_boolean(cscene, "caustics_reflective"));
   integrator->set_caustics_refractive(get_boolean(cscene, "caustics_refractive"));
@@ -682,6 +689,7 @@ static bool get_known_pass_type(BL::RenderPass &b_pass, PassType &type, PassMode
 
   MAP_PASS("AdaptiveAuxBuffer", PASS_ADAPTIVE_AUX_BUFFER, false);
   MAP_PASS("Debug Sample Count", PASS_SAMPLE_COUNT, false);
+  MAP_PASS("Debug Render Time", PASS_RENDER_TIME, false);
 
   MAP_PASS("Guiding Color", PASS_GUIDING_COLOR, false);
   MAP_PASS("Guiding Probability", PASS_GUIDING_PROBABILITY, false);
@@ -854,6 +862,13 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
   params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
   params.use_bvh_compact_structure = RNA_boolean_get(&cscene, "debug_use_compact_bvh");
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
+  /* With persistent data geometry is kept between frames, so the BVH of deforming geometry can
+   * be refit instead of rebuilt. */
+  params.use_bvh_refit = background && b_scene.render().use_persistent_data();
+  /* Likewise diced subdivision patches can be reused when the edge factors did not change. */
+  params.use_subd_dicing_cache = background && b_scene.render().use_persistent_data();
+  /* The light tree can only be refit when the scene is updated again. */
+  params.use_light_tree_refit = !background || b_scene.render().use_persistent_data();
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
 
   PointerRNA csscene = RNA_pointer_get(&b_scene.ptr, "cycles_curves");
@@ -875,6 +890,9 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
     params.texture_limit = 0;
   }
 
+  params.use_texture_cache = RNA_boolean_get(&cscene, "use_texture_cache");
+  params.texture_cache_size = RNA_int_get(&cscene, "texture_cache_size");
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
@@ -977,6 +995,7 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
   if (background) {
     params.use_auto_tile = RNA_boolean_get(&cscene, "use_auto_tile");
     params.tile_size = max(get_int(cscene, "tile_size"), 8);
+    params.use_half_float_tile_passes = get_boolean(cscene, "use_half_float_tile_passes");
   }
   else {
     params.use_auto_tile = false;
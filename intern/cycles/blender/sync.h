@@ -186,6 +186,8 @@ class BlenderSync {
                           bool object_updated,
                           bool use_particle_hair,
                           TaskPool *task_pool);
+  bool geometry_is_updated(Geometry *geom);
+  void deduplicate_geometry();
 
   void sync_geometry_motion(BL::Depsgraph &b_depsgraph,
                             BObjectInfo &b_ob_info,
@@ -233,6 +235,9 @@ class BlenderSync {
   id_map<ObjectKey, Light> light_map;
   id_map<ParticleSystemKey, ParticleSystem> particle_system_map;
   set<Geometry *> geometry_synced;
+  /** Geometry whose data was cleared because it is identical to other geometry, which its
+   * objects use instead. */
+  set<Geometry *> geometry_duplicates;
   set<Geometry *> geometry_motion_synced;
   set<Geometry *> geometry_motion_attribute_synced;
   /** Remember which geometries come from which objects to be able to sync them after changes. */
@@ -13,7 +13,9 @@
 
 #include "util/algorithm.h"
 #include "util/boundbox.h"
+#include "util/tbb.h"
 #include "util/types.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -81,75 +83,31 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   num_bins = min(size_t(MAX_BINS), size_t(4.0f + 0.05f * size()));
   scale = rcp(cent_bounds_.size()) * make_float3((float)num_bins);
 
-  /* initialize binning counter and bounds */
-  BoundBox bin_bounds[MAX_BINS][4]; /* bounds for every bin in every dimension */
-  int4 bin_count[MAX_BINS];         /* number of primitives mapped to bin */
-
-  for (size_t i = 0; i < num_bins; i++) {
-    bin_count[i] = make_int4(0);
-    bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
+  /* map geometry to bins */
+  Bins bins;
+  bins_init(bins);
+
+  if (size() >= PARALLEL_MIN_SIZE) {
+    /* Deterministic reduction, so that the tree does not depend on thread scheduling. */
+    bins = parallel_deterministic_reduce(
+        blocked_range<size_t>(start(), end(), PARALLEL_GRAIN_SIZE),
+        bins,
+        [&](const blocked_range<size_t> &r, Bins local_bins) {
+          bins_add(prims, r.begin(), r.end(), local_bins);
+          return local_bins;
+        },
+        [&](Bins a, const Bins &b) {
+          bins_merge(a, b);
+          return a;
+        });
   }
-
-  /* map geometry to bins, unrolled once */
-  {
-    int64_t i;
-
-    for (i = 0; i < int64_t(size()) - 1; i += 2) {
-      prefetch_L2(&prims[start() + i + 8]);
-
-      /* map even and odd primitive to bin */
-      const BVHReference &prim0 = prims[start() + i + 0];
-      const BVHReference &prim1 = prims[start() + i + 1];
-
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      BoundBox bounds1 = get_prim_bounds(prim1);
-
-      int4 bin0 = get_bin(bounds0);
-      int4 bin1 = get_bin(bounds1);
-
-      /* increase bounds for bins for even primitive */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-
-      /* increase bounds of bins for odd primitive */
-      int b10 = (int)extract<0>(bin1);
-      bin_count[b10][0]++;
-      bin_bounds[b10][0].grow(bounds1);
-      int b11 = (int)extract<1>(bin1);
-      bin_count[b11][1]++;
-      bin_bounds[b11][1].grow(bounds1);
-      int b12 = (int)extract<2>(bin1);
-      bin_count[b12][2]++;
-      bin_bounds[b12][2].grow(bounds1);
-    }
-
-    /* for uneven number of primitives */
-    if (i < int64_t(size())) {
-      /* map primitive to bin */
-      const BVHReference &prim0 = prims[start() + i];
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      int4 bin0 = get_bin(bounds0);
-
-      /* increase bounds of bins */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-    }
+  else {
+    bins_add(prims, start(), end(), bins);
   }
 
+  const BoundBox(*bin_bounds)[3] = bins.bounds;
+  const int4 *bin_count = bins.count;
+
   /* sweep from right to left and compute parallel prefix of merged bounds */
   float4 r_area[MAX_BINS];  /* area of bounds of primitives on the right */
   float4 r_count[MAX_BINS]; /* number of primitives on the right */
@@ -211,12 +169,102 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   leafSAH = bounds_.half_area() * blocks(size());
 }
 
+void BVHObjectBinning::bins_init(Bins &bins) const
+{
+  for (size_t i = 0; i < num_bins; i++) {
+    bins.count[i] = make_int4(0);
+    bins.bounds[i][0] = bins.bounds[i][1] = bins.bounds[i][2] = BoundBox::empty;
+  }
+}
+
+void BVHObjectBinning::bins_merge(Bins &bins, const Bins &other) const
+{
+  for (size_t i = 0; i < num_bins; i++) {
+    bins.count[i] = bins.count[i] + other.count[i];
+    bins.bounds[i][0].grow(other.bounds[i][0]);
+    bins.bounds[i][1].grow(other.bounds[i][1]);
+    bins.bounds[i][2].grow(other.bounds[i][2]);
+  }
+}
+
+void BVHObjectBinning::bins_add(BVHReference *prims,
+                                const size_t begin,
+                                const size_t end,
+                                Bins &bins) const
+{
+  int4 *bin_count = bins.count;
+  BoundBox(*bin_bounds)[3] = bins.bounds;
+
+  /* map geometry to bins, unrolled once */
+  int64_t i;
+
+  for (i = int64_t(begin); i < int64_t(end) - 1; i += 2) {
+    prefetch_L2(&prims[i + 8]);
+
+    /* map even and odd primitive to bin */
+    const BVHReference &prim0 = prims[i + 0];
+    const BVHReference &prim1 = prims[i + 1];
+
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    BoundBox bounds1 = get_prim_bounds(prim1);
+
+    int4 bin0 = get_bin(bounds0);
+    int4 bin1 = get_bin(bounds1);
+
+    /* increase bounds for bins for even primitive */
+    int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+
+    /* increase bounds of bins for odd primitive */
+    int b10 = (int)extract<0>(bin1);
+    bin_count[b10][0]++;
+    bin_bounds[b10][0].grow(bounds1);
+    int b11 = (int)extract<1>(bin1);
+    bin_count[b11][1]++;
+    bin_bounds[b11][1].grow(bounds1);
+    int b12 = (int)extract<2>(bin1);
+    bin_count[b12][2]++;
+    bin_bounds[b12][2].grow(bounds1);
+  }
+
+  /* for uneven number of primitives */
+  if (i < int64_t(end)) {
+    /* map primitive to bin */
+    const BVHReference &prim0 = prims[i];
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    int4 bin0 = get_bin(bounds0);
+
+    /* increase bounds of bins */
+    int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+  }
+}
+
 void BVHObjectBinning::split(BVHReference *prims,
                              BVHObjectBinning &left_o,
                              BVHObjectBinning &right_o) const
 {
   size_t N = size();
 
+  if (N >= PARALLEL_MIN_SIZE) {
+    split_parallel(prims, left_o, right_o);
+    return;
+  }
+
   BoundBox lgeom_bounds = BoundBox::empty;
   BoundBox rgeom_bounds = BoundBox::empty;
   BoundBox lcent_bounds = BoundBox::empty;
@@ -229,11 +277,9 @@ void BVHObjectBinning::split(BVHReference *prims,
     prefetch_L2(&prims[start() + r - 8]);
 
     BVHReference prim = prims[start() + l];
-    BoundBox unaligned_bounds = get_prim_bounds(prim);
-    float3 unaligned_center = unaligned_bounds.center2();
     float3 center = prim.bounds().center2();
 
-    if (get_bin(unaligned_center)[dim] < pos) {
+    if (is_left(prim)) {
       lgeom_bounds.grow(prim.bounds());
       lcent_bounds.grow(center);
       l++;
@@ -255,10 +301,19 @@ void BVHObjectBinning::split(BVHReference *prims,
 
   /* object medium split if we did not make progress, can happen when all
    * primitives have same centroid */
-  lgeom_bounds = BoundBox::empty;
-  rgeom_bounds = BoundBox::empty;
-  lcent_bounds = BoundBox::empty;
-  rcent_bounds = BoundBox::empty;
+  median_split(prims, left_o, right_o);
+}
+
+void BVHObjectBinning::median_split(BVHReference *prims,
+                                    BVHObjectBinning &left_o,
+                                    BVHObjectBinning &right_o) const
+{
+  size_t N = size();
+
+  BoundBox lgeom_bounds = BoundBox::empty;
+  BoundBox rgeom_bounds = BoundBox::empty;
+  BoundBox lcent_bounds = BoundBox::empty;
+  BoundBox rcent_bounds = BoundBox::empty;
 
   for (size_t i = 0; i < N / 2; i++) {
     lgeom_bounds.grow(prims[start() + i].bounds());
@@ -275,4 +330,109 @@ void BVHObjectBinning::split(BVHReference *prims,
   left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), N / 2), prims);
 }
 
+/* Partition with multiple threads. Primitives are classified per chunk, and then copied to
+ * their destination through a temporary array. Unlike the in-place partition, this keeps the
+ * order of primitives on each side. */
+void BVHObjectBinning::split_parallel(BVHReference *prims,
+                                      BVHObjectBinning &left_o,
+                                      BVHObjectBinning &right_o) const
+{
+  const size_t N = size();
+  const size_t num_chunks = divide_up(N, size_t(PARALLEL_GRAIN_SIZE));
+
+  struct Chunk {
+    size_t num_left;
+    size_t left_offset;
+    size_t right_offset;
+    BoundBox lgeom_bounds;
+    BoundBox rgeom_bounds;
+    BoundBox lcent_bounds;
+    BoundBox rcent_bounds;
+  };
+  vector<Chunk> chunks(num_chunks);
+
+  /* Count primitives and compute bounds on each side, per chunk. */
+  parallel_for(blocked_range<size_t>(0, num_chunks, 1), [&](const blocked_range<size_t> &r) {
+    for (size_t c = r.begin(); c != r.end(); c++) {
+      Chunk &chunk = chunks[c];
+      chunk.num_left = 0;
+      chunk.lgeom_bounds = chunk.rgeom_bounds = BoundBox::empty;
+      chunk.lcent_bounds = chunk.rcent_bounds = BoundBox::empty;
+
+      const size_t chunk_end = min(N, (c + 1) * PARALLEL_GRAIN_SIZE);
+      for (size_t i = c * PARALLEL_GRAIN_SIZE; i < chunk_end; i++) {
+        const BVHReference &prim = prims[start() + i];
+        const float3 center = prim.bounds().center2();
+
+        if (is_left(prim)) {
+          chunk.lgeom_bounds.grow(prim.bounds());
+          chunk.lcent_bounds.grow(center);
+          chunk.num_left++;
+        }
+        else {
+          chunk.rgeom_bounds.grow(prim.bounds());
+          chunk.rcent_bounds.grow(center);
+        }
+      }
+    }
+  });
+
+  /* Compute destination of every chunk, and bounds of both sides. */
+  BoundBox lgeom_bounds = BoundBox::empty;
+  BoundBox rgeom_bounds = BoundBox::empty;
+  BoundBox lcent_bounds = BoundBox::empty;
+  BoundBox rcent_bounds = BoundBox::empty;
+  size_t num_left = 0;
+
+  for (Chunk &chunk : chunks) {
+    chunk.left_offset = num_left;
+    num_left += chunk.num_left;
+
+    lgeom_bounds.grow(chunk.lgeom_bounds);
+    rgeom_bounds.grow(chunk.rgeom_bounds);
+    lcent_bounds.grow(chunk.lcent_bounds);
+    rcent_bounds.grow(chunk.rcent_bounds);
+  }
+
+  if (num_left == 0 || num_left == N) {
+    /* object medium split if we did not make progress */
+    median_split(prims, left_o, right_o);
+    return;
+  }
+
+  size_t right_offset = num_left;
+  for (size_t c = 0; c < num_chunks; c++) {
+    const size_t chunk_size = min(N, (c + 1) * PARALLEL_GRAIN_SIZE) - c * PARALLEL_GRAIN_SIZE;
+    chunks[c].right_offset = right_offset;
+    right_offset += chunk_size - chunks[c].num_left;
+  }
+
+  /* Scatter primitives to their side, and copy back. */
+  vector<BVHReference> sorted(N);
+
+  parallel_for(blocked_range<size_t>(0, num_chunks, 1), [&](const blocked_range<size_t> &r) {
+    for (size_t c = r.begin(); c != r.end(); c++) {
+      size_t left = chunks[c].left_offset;
+      size_t right = chunks[c].right_offset;
+
+      const size_t chunk_end = min(N, (c + 1) * PARALLEL_GRAIN_SIZE);
+      for (size_t i = c * PARALLEL_GRAIN_SIZE; i < chunk_end; i++) {
+        const BVHReference &prim = prims[start() + i];
+        sorted[is_left(prim) ? left++ : right++] = prim;
+      }
+    }
+  });
+
+  parallel_for(blocked_range<size_t>(0, N, PARALLEL_GRAIN_SIZE),
+               [&](const blocked_range<size_t> &r) {
+                 std::copy(sorted.begin() + r.begin(),
+                           sorted.begin() + r.end(),
+                           prims + start() + r.begin());
+               });
+
+  right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + num_left, N - num_left),
+                             prims);
+  left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), num_left), prims);
+}
+
 CCL_NAMESPACE_END
@@ -17,12 +17,15 @@ CCL_NAMESPACE_BEGIN
 
 class BVHBuild;
 
-/* Single threaded object binner. Finds the split with the best SAH heuristic
+/* Object binner. Finds the split with the best SAH heuristic
  * by testing for each dimension multiple partitionings for regular spaced
  * partition locations. A partitioning for a partition location is computed,
  * by putting primitives whose centroid is on the left and right of the split
  * location to different sets. The SAH is evaluated by computing the number of
- * blocks occupied by the primitives in the partitions. */
+ * blocks occupied by the primitives in the partitions.
+ *
+ * Large ranges near the top of the tree are binned and partitioned with
+ * multiple threads, smaller ones are handled by the build tasks. */
 
 class BVHObjectBinning : public BVHRange {
  public:
@@ -59,6 +62,28 @@ class BVHObjectBinning : public BVHRange {
   enum { MAX_BINS = 32 };
   enum { LOG_BLOCK_SIZE = 2 };
 
+  /* Ranges of at least this size are binned and split with multiple threads,
+   * in chunks of the grain size. */
+  enum { PARALLEL_MIN_SIZE = 65536 };
+  enum { PARALLEL_GRAIN_SIZE = 8192 };
+
+  /* Bounds and number of primitives for every bin in every dimension. */
+  struct Bins {
+    BoundBox bounds[MAX_BINS][3];
+    int4 count[MAX_BINS];
+  };
+
+  void bins_init(Bins &bins) const;
+  void bins_merge(Bins &bins, const Bins &other) const;
+  void bins_add(BVHReference *prims, const size_t begin, const size_t end, Bins &bins) const;
+
+  void split_parallel(BVHReference *prims,
+                      BVHObjectBinning &left_o,
+                      BVHObjectBinning &right_o) const;
+  void median_split(BVHReference *prims,
+                    BVHObjectBinning &left_o,
+                    BVHObjectBinning &right_o) const;
+
   /* computes the bin numbers for each dimension for a box. */
   __forceinline int4 get_bin(const BoundBox &box) const
   {
@@ -96,6 +121,12 @@ class BVHObjectBinning : public BVHRange {
       return unaligned_heuristic_->compute_aligned_prim_boundbox(prim, *aligned_space_);
     }
   }
+
+  /* test if primitive goes to the left side of the best split. */
+  __forceinline bool is_left(const BVHReference &prim) const
+  {
+    return get_bin(get_prim_bounds(prim).center2())[dim] < pos;
+  }
 };
 
 CCL_NAMESPACE_END
@@ -146,8 +146,13 @@ void BVHEmbree::build(Progress &progress,
   build_quality = dynamic ? RTC_BUILD_QUALITY_LOW :
                             (params.use_spatial_split ? RTC_BUILD_QUALITY_HIGH :
                                                         RTC_BUILD_QUALITY_MEDIUM);
+  /* With refitting, the first build still uses the full quality, so scenes that don't change
+   * trace as fast as without it. Updates switch to the two level builder, see #refit. */
   rtcSetSceneBuildQuality(scene, build_quality);
 
+  object_geometry.clear();
+  object_geometry.resize(objects.size());
+
   int i = 0;
   foreach (Object *ob, objects) {
     if (params.top_level) {
@@ -253,6 +258,27 @@ void BVHEmbree::add_object(Object *ob, int i)
   }
 }
 
+void BVHEmbree::attach_geometry(RTCGeometry geom_id,
+                                const int i,
+                                const unsigned int id,
+                                const bool is_instance)
+{
+  rtcAttachGeometryByID(scene, geom_id, id);
+  rtcReleaseGeometry(geom_id);
+
+  object_geometry[i].id = id;
+  object_geometry[i].geom = objects[i]->get_geometry();
+  object_geometry[i].is_instance = is_instance;
+}
+
+void BVHEmbree::remove_object(const int i)
+{
+  if (object_geometry[i].id != RTC_INVALID_GEOMETRY_ID) {
+    rtcDetachGeometry(scene, object_geometry[i].id);
+    object_geometry[i] = ObjectGeometry();
+  }
+}
+
 void BVHEmbree::add_instance(Object *ob, int i)
 {
   BVHEmbree *instance_bvh = (BVHEmbree *)(ob->get_geometry()->bvh);
@@ -295,8 +321,7 @@ void BVHEmbree::add_instance(Object *ob, int i)
 #  endif
 
   rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
+  attach_geometry(geom_id, i, i * 2, true);
 }
 
 void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
@@ -318,7 +343,8 @@ void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
   const size_t num_triangles = mesh->num_triangles();
 
   RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_TRIANGLE);
-  rtcSetGeometryBuildQuality(geom_id, build_quality);
+  rtcSetGeometryBuildQuality(geom_id,
+                             params.use_refit ? RTC_BUILD_QUALITY_REFIT : build_quality);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
   const int *triangles = mesh->get_triangles().data();
@@ -357,8 +383,7 @@ void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
 #  endif
 
   rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
+  attach_geometry(geom_id, i, i * 2, false);
 }
 
 void BVHEmbree::set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update)
@@ -389,48 +414,51 @@ void BVHEmbree::set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, con
       verts = &attr_mP->data_float3()[t_ * num_verts];
     }
 
-    if (update) {
-      rtcUpdateGeometryBuffer(geom_id, RTC_BUFFER_TYPE_VERTEX, t);
+    if (!rtc_device_is_sycl) {
+      static_assert(sizeof(float3) == 16,
+                    "Embree requires that each buffer element be readable with 16-byte SSE load "
+                    "instructions");
+      /* Share the buffer again on update, as the vertex array may have been reallocated. */
+      rtcSetSharedGeometryBuffer(geom_id,
+                                 RTC_BUFFER_TYPE_VERTEX,
+                                 t,
+                                 RTC_FORMAT_FLOAT3,
+                                 verts,
+                                 0,
+                                 sizeof(float3),
+                                 num_verts);
     }
     else {
-      if (!rtc_device_is_sycl) {
-        static_assert(sizeof(float3) == 16,
-                      "Embree requires that each buffer element be readable with 16-byte SSE load "
-                      "instructions");
-        rtcSetSharedGeometryBuffer(geom_id,
-                                   RTC_BUFFER_TYPE_VERTEX,
-                                   t,
-                                   RTC_FORMAT_FLOAT3,
-                                   verts,
-                                   0,
-                                   sizeof(float3),
-                                   num_verts);
-      }
-      else {
-        /* NOTE(sirgienko): If the Embree device is a SYCL device, then Embree execution will
-         * happen on GPU, and we cannot use standard host pointers at this point. So instead
-         * of making a shared geometry buffer - a new Embree buffer will be created and data
-         * will be copied. */
-        /* As float3 is packed on GPU side, we map it to packed_float3. */
-        /* There is no need for additional padding in rtcSetNewGeometryBuffer since Embree 3.6:
-         * "Fixed automatic vertex buffer padding when using rtcSetNewGeometry API function". */
-        packed_float3 *verts_buffer = (packed_float3 *)rtcSetNewGeometryBuffer(
-            geom_id,
-            RTC_BUFFER_TYPE_VERTEX,
-            t,
-            RTC_FORMAT_FLOAT3,
-            sizeof(packed_float3),
-            num_verts);
-        assert(verts_buffer);
-        if (verts_buffer) {
-          for (size_t i = (size_t)0; i < num_verts; ++i) {
-            verts_buffer[i].x = verts[i].x;
-            verts_buffer[i].y = verts[i].y;
-            verts_buffer[i].z = verts[i].z;
-          }
+      /* NOTE(sirgienko): If the Embree device is a SYCL device, then Embree execution will
+       * happen on GPU, and we cannot use standard host pointers at this point. So instead
+       * of making a shared geometry buffer - a new Embree buffer will be created and data
+       * will be copied. */
+      /* As float3 is packed on GPU side, we map it to packed_float3. */
+      /* There is no need for additional padding in rtcSetNewGeometryBuffer since Embree 3.6:
+       * "Fixed automatic vertex buffer padding when using rtcSetNewGeometry API function". */
+      packed_float3 *verts_buffer = (update) ?
+                                        (packed_float3 *)rtcGetGeometryBufferData(
+                                            geom_id, RTC_BUFFER_TYPE_VERTEX, t) :
+                                        (packed_float3 *)rtcSetNewGeometryBuffer(
+                                            geom_id,
+                                            RTC_BUFFER_TYPE_VERTEX,
+                                            t,
+                                            RTC_FORMAT_FLOAT3,
+                                            sizeof(packed_float3),
+                                            num_verts);
+      assert(verts_buffer);
+      if (verts_buffer) {
+        for (size_t i = (size_t)0; i < num_verts; ++i) {
+          verts_buffer[i].x = verts[i].x;
+          verts_buffer[i].y = verts[i].y;
+          verts_buffer[i].z = verts[i].z;
         }
       }
     }
+
+    if (update) {
+      rtcUpdateGeometryBuffer(geom_id, RTC_BUFFER_TYPE_VERTEX, t);
+    }
   }
 }
 
@@ -610,8 +638,7 @@ void BVHEmbree::add_points(const Object *ob, const PointCloud *pointcloud, int i
 #  endif
 
   rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
+  attach_geometry(geom_id, i, i * 2, false);
 }
 
 void BVHEmbree::add_curves(const Object *ob, const Hair *hair, int i)
@@ -680,48 +707,73 @@ void BVHEmbree::add_curves(const Object *ob, const Hair *hair, int i)
 #  endif
 
   rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2 + 1);
-  rtcReleaseGeometry(geom_id);
+  attach_geometry(geom_id, i, i * 2 + 1, false);
 }
 
 void BVHEmbree::refit(Progress &progress)
 {
   progress.set_substatus("Refitting BVH nodes");
 
+  if (params.use_refit) {
+    /* Use the two level builder that builds a BVH per geometry and one over them, so that
+     * geometry can be refit or rebuilt individually from now on. */
+    rtcSetSceneBuildQuality(scene, RTC_BUILD_QUALITY_LOW);
+  }
+
   /* Update all vertex buffers, then tell Embree to rebuild/-fit the BVHs. */
-  unsigned geom_id = 0;
+  int i = 0;
   foreach (Object *ob, objects) {
-    if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
-      Geometry *geom = ob->get_geometry();
-
-      if (geom->is_mesh() || geom->is_volume()) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        if (mesh->num_triangles() > 0) {
-          RTCGeometry geom = rtcGetGeometry(scene, geom_id);
-          set_tri_vertex_buffer(geom, mesh, true);
-          rtcSetGeometryUserData(geom, (void *)mesh->prim_offset);
-          rtcCommitGeometry(geom);
-        }
-      }
-      else if (geom->is_hair()) {
-        Hair *hair = static_cast<Hair *>(geom);
-        if (hair->num_curves() > 0) {
-          RTCGeometry geom = rtcGetGeometry(scene, geom_id + 1);
-          set_curve_vertex_buffer(geom, hair, true);
-          rtcSetGeometryUserData(geom, (void *)hair->curve_segment_offset);
-          rtcCommitGeometry(geom);
-        }
-      }
-      else if (geom->is_pointcloud()) {
-        PointCloud *pointcloud = static_cast<PointCloud *>(geom);
-        if (pointcloud->num_points() > 0) {
-          RTCGeometry geom = rtcGetGeometry(scene, geom_id);
-          set_point_vertex_buffer(geom, pointcloud, true);
-          rtcCommitGeometry(geom);
+    Geometry *geom = ob->get_geometry();
+
+    if (params.top_level) {
+      const bool is_traceable = ob->is_traceable();
+      const bool is_instance = geom->is_instanced();
+
+      /* Add objects again when their geometry changed topology, so that Embree builds a new BVH
+       * for them. Instances are cheap to add, and may have a new transform or instanced BVH. */
+      if (!is_traceable || is_instance || geom->need_update_rebuild ||
+          object_geometry[i].is_instance || object_geometry[i].geom != geom)
+      {
+        remove_object(i);
+        if (is_traceable) {
+          if (is_instance) {
+            add_instance(ob, i);
+          }
+          else {
+            add_object(ob, i);
+          }
         }
+        ++i;
+        continue;
       }
     }
-    geom_id += 2;
+
+    if (object_geometry[i].id == RTC_INVALID_GEOMETRY_ID) {
+      ++i;
+      continue;
+    }
+
+    RTCGeometry rtc_geom = rtcGetGeometry(scene, object_geometry[i].id);
+
+    if (geom->is_mesh() || geom->is_volume()) {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      set_tri_vertex_buffer(rtc_geom, mesh, true);
+      rtcSetGeometryUserData(rtc_geom, (void *)mesh->prim_offset);
+      rtcCommitGeometry(rtc_geom);
+    }
+    else if (geom->is_hair()) {
+      Hair *hair = static_cast<Hair *>(geom);
+      set_curve_vertex_buffer(rtc_geom, hair, true);
+      rtcSetGeometryUserData(rtc_geom, (void *)hair->curve_segment_offset);
+      rtcCommitGeometry(rtc_geom);
+    }
+    else if (geom->is_pointcloud()) {
+      PointCloud *pointcloud = static_cast<PointCloud *>(geom);
+      set_point_vertex_buffer(rtc_geom, pointcloud, true);
+      rtcSetGeometryUserData(rtc_geom, (void *)pointcloud->prim_offset);
+      rtcCommitGeometry(rtc_geom);
+    }
+    ++i;
   }
 
   rtcCommitScene(scene);
@@ -54,6 +54,7 @@ class BVHEmbree : public BVH {
 
   void add_object(Object *ob, int i);
   void add_instance(Object *ob, int i);
+  void remove_object(int i);
   void add_curves(const Object *ob, const Hair *hair, int i);
   void add_points(const Object *ob, const PointCloud *pointcloud, int i);
   void add_triangles(const Object *ob, const Mesh *mesh, int i);
@@ -65,9 +66,20 @@ class BVHEmbree : public BVH {
                                const PointCloud *pointcloud,
                                const bool update);
 
+  void attach_geometry(RTCGeometry geom_id, int i, unsigned int id, bool is_instance);
+
   RTCDevice rtc_device;
   bool rtc_device_is_sycl;
   enum RTCBuildQuality build_quality;
+
+  /* Geometry attached to the scene for each object, to update objects individually when
+   * refitting. */
+  struct ObjectGeometry {
+    unsigned int id = RTC_INVALID_GEOMETRY_ID;
+    const Geometry *geom = nullptr;
+    bool is_instance = false;
+  };
+  vector<ObjectGeometry> object_geometry;
 };
 
 CCL_NAMESPACE_END
@@ -91,6 +91,10 @@ class BVHParams {
   /* Use compact acceleration structure (Embree)*/
   bool use_compact_structure;
 
+  /* Build the BVH so that geometry with unchanged topology can be refit, instead of rebuilding
+   * it when vertices move (Embree). */
+  bool use_refit;
+
   /* Split time range to this number of steps and create leaf node for each
    * of this time steps.
    *
@@ -135,6 +139,7 @@ class BVHParams {
     bvh_layout = BVH_LAYOUT_BVH2;
     use_compact_structure = false;
     use_unaligned_nodes = false;
+    use_refit = false;
 
     num_motion_curve_steps = 0;
     num_motion_triangle_steps = 0;
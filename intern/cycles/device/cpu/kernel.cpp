@@ -9,7 +9,8 @@
 CCL_NAMESPACE_BEGIN
 
 #define KERNEL_FUNCTIONS(name) \
-  KERNEL_NAME_EVAL(cpu, name), KERNEL_NAME_EVAL(cpu_sse42, name), KERNEL_NAME_EVAL(cpu_avx2, name)
+  KERNEL_NAME_EVAL(cpu, name), KERNEL_NAME_EVAL(cpu_sse42, name), \
+      KERNEL_NAME_EVAL(cpu_avx2, name), KERNEL_NAME_EVAL(cpu_avx512, name)
 
 #define REGISTER_KERNEL(name) name(KERNEL_FUNCTIONS(name))
 #define REGISTER_KERNEL_FILM_CONVERT(name) \
@@ -32,6 +33,10 @@ CPUKernels::CPUKernels()
       REGISTER_KERNEL(integrator_shade_volume),
       REGISTER_KERNEL(integrator_shade_dedicated_light),
       REGISTER_KERNEL(integrator_megakernel),
+      REGISTER_KERNEL(integrator_megakernel_path_step),
+      REGISTER_KERNEL(integrator_megakernel_shadow_paths),
+      REGISTER_KERNEL(integrator_intersect_closest_packet),
+      REGISTER_KERNEL(integrator_intersect_shadow_packet),
       /* Shader evaluation. */
       REGISTER_KERNEL(shader_eval_displace),
       REGISTER_KERNEL(shader_eval_background),
@@ -13,6 +13,7 @@ CCL_NAMESPACE_BEGIN
 struct KernelGlobalsCPU;
 struct KernelFilmConvert;
 struct IntegratorStateCPU;
+struct IntegratorShadowStateCPU;
 struct TileInfo;
 
 class CPUKernels {
@@ -28,6 +29,15 @@ class CPUKernels {
                                                             KernelWorkTile *tile,
                                                             ccl_global float *render_buffer)>;
 
+  using IntegratorPacketFunction = CPUKernelFunction<void (*)(const KernelGlobalsCPU *kg,
+                                                              IntegratorStateCPU *const *states,
+                                                              const int num_states,
+                                                              ccl_global float *render_buffer)>;
+  using IntegratorShadowPacketFunction =
+      CPUKernelFunction<void (*)(const KernelGlobalsCPU *kg,
+                                 IntegratorShadowStateCPU *const *states,
+                                 const int num_states)>;
+
   IntegratorInitFunction integrator_init_from_camera;
   IntegratorInitFunction integrator_init_from_bake;
   IntegratorShadeFunction integrator_intersect_closest;
@@ -42,6 +52,12 @@ class CPUKernels {
   IntegratorShadeFunction integrator_shade_volume;
   IntegratorShadeFunction integrator_shade_dedicated_light;
   IntegratorShadeFunction integrator_megakernel;
+  /* Single steps of the megakernel, used by the wavefront path tracing mode. */
+  IntegratorShadeFunction integrator_megakernel_path_step;
+  IntegratorShadeFunction integrator_megakernel_shadow_paths;
+  /* Intersection of coherent rays in packets, used by the wavefront path tracing mode. */
+  IntegratorPacketFunction integrator_intersect_closest_packet;
+  IntegratorShadowPacketFunction integrator_intersect_shadow_packet;
 
   /* Shader evaluation. */
 
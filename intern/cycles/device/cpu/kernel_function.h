@@ -18,9 +18,10 @@ template<typename FunctionType> class CPUKernelFunction {
  public:
   CPUKernelFunction(FunctionType kernel_default,
                     FunctionType kernel_sse42,
-                    FunctionType kernel_avx2)
+                    FunctionType kernel_avx2,
+                    FunctionType kernel_avx512)
   {
-    kernel_info_ = get_best_kernel_info(kernel_default, kernel_sse42, kernel_avx2);
+    kernel_info_ = get_best_kernel_info(kernel_default, kernel_sse42, kernel_avx2, kernel_avx512);
   }
 
   template<typename... Args> inline auto operator()(Args... args) const
@@ -55,11 +56,19 @@ template<typename FunctionType> class CPUKernelFunction {
 
   KernelInfo get_best_kernel_info(FunctionType kernel_default,
                                   FunctionType kernel_sse42,
-                                  FunctionType kernel_avx2)
+                                  FunctionType kernel_avx2,
+                                  FunctionType kernel_avx512)
   {
     /* Silence warnings about unused variables when compiling without some architectures. */
     (void)kernel_sse42;
     (void)kernel_avx2;
+    (void)kernel_avx512;
+
+#ifdef WITH_CYCLES_OPTIMIZED_KERNEL_AVX512
+    if (DebugFlags().cpu.has_avx512() && system_cpu_support_avx512()) {
+      return KernelInfo("AVX-512", kernel_avx512);
+    }
+#endif
 
 #ifdef WITH_CYCLES_OPTIMIZED_KERNEL_AVX2
     if (DebugFlags().cpu.has_avx2() && system_cpu_support_avx2()) {
@@ -16,9 +16,12 @@
 #include "scene/scene.h"
 #include "session/buffers.h"
 
+#include "util/algorithm.h"
 #include "util/atomic.h"
+#include "util/debug.h"
 #include "util/log.h"
 #include "util/tbb.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -31,6 +34,11 @@ static inline tbb::task_arena local_tbb_arena_create(const Device *device)
   return tbb::task_arena(device->info.cpu_threads);
 }
 
+/* Number of paths in flight per thread in wavefront mode. The CPU integrator state is big, mostly
+ * due to the shadow intersection arrays, but those are rarely touched in full so most of their
+ * memory is never committed. */
+static constexpr int WAVEFRONT_PATHS_NUM = 256;
+
 /* Get CPUKernelThreadGlobals for the current thread. */
 static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
     vector<CPUKernelThreadGlobals> &kernel_thread_globals)
@@ -56,6 +64,8 @@ void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  wavefront_states_.resize(kernel_thread_globals_.size());
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -74,31 +84,62 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   }
 
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+  if (use_wavefront()) {
+    /* Split the pixels into enough ranges to balance the work between threads. */
+    const int64_t tasks_num = int64_t(kernel_thread_globals_.size()) * 8;
+    const int64_t grain_size = std::clamp(
+        total_pixels_num / tasks_num, int64_t(1), int64_t(WAVEFRONT_PATHS_NUM));
+
+    local_arena.execute([&]() {
+      parallel_for(blocked_range<int64_t>(0, total_pixels_num, grain_size),
+                   [&](const blocked_range<int64_t> &range) {
+                     if (is_cancel_requested()) {
+                       return;
+                     }
+
+                     CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(
+                         kernel_thread_globals_);
+                     IntegratorStateCPU *states = wavefront_states_get();
+
+                     render_samples_wavefront(kernel_globals,
+                                              states,
+                                              range.begin(),
+                                              range.end(),
+                                              start_sample,
+                                              samples_num,
+                                              sample_offset);
+                   });
+    });
+  }
+  else {
+    local_arena.execute([&]() {
+      parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const int y = work_index / image_width;
+        const int x = work_index - y * image_width;
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+        KernelWorkTile work_tile;
+        work_tile.x = effective_buffer_params_.full_x + x;
+        work_tile.y = effective_buffer_params_.full_y + y;
+        work_tile.w = 1;
+        work_tile.h = 1;
+        work_tile.start_sample = start_sample;
+        work_tile.sample_offset = sample_offset;
+        work_tile.num_samples = 1;
+        work_tile.offset = effective_buffer_params_.offset;
+        work_tile.stride = effective_buffer_params_.stride;
 
-      CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+        render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+      });
     });
-  });
+  }
+
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
       kernel_globals.stop_profiling();
@@ -127,11 +168,22 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_glo
   KernelWorkTile sample_work_tile = work_tile;
   float *render_buffer = buffers_->buffer.data();
 
+  /* Time of every sample is accumulated in the render time pass, the work tile is one pixel. */
+  float *render_time = nullptr;
+  if (device_scene_->data.film.pass_render_time != PASS_UNUSED) {
+    const int64_t render_pixel_index = work_tile.offset + work_tile.x +
+                                       work_tile.y * work_tile.stride;
+    render_time = render_buffer + render_pixel_index * device_scene_->data.film.pass_stride +
+                  device_scene_->data.film.pass_render_time;
+  }
+
   for (int sample = 0; sample < samples_num; ++sample) {
     if (is_cancel_requested()) {
       break;
     }
 
+    const double sample_start_time = (render_time) ? time_dt() : 0.0;
+
     if (has_bake) {
       if (!kernels_.integrator_init_from_bake(
               kernel_globals, state, &sample_work_tile, render_buffer))
@@ -160,10 +212,232 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_glo
       kernels_.integrator_megakernel(kernel_globals, shadow_catcher_state, render_buffer);
     }
 
+    if (render_time) {
+      /* In milliseconds. */
+      *render_time += (float)((time_dt() - sample_start_time) * 1000.0);
+    }
+
     ++sample_work_tile.start_sample;
   }
 }
 
+bool PathTraceWorkCPU::use_wavefront() const
+{
+  if (!DebugFlags().cpu.wavefront) {
+    return false;
+  }
+  /* Guiding records the segments of one path at a time per thread. */
+  if (device_scene_->data.integrator.use_guiding) {
+    return false;
+  }
+  /* Paths of many pixels are in flight together, so time can not be measured per pixel. */
+  if (device_scene_->data.film.pass_render_time != PASS_UNUSED) {
+    return false;
+  }
+  return true;
+}
+
+IntegratorStateCPU *PathTraceWorkCPU::wavefront_states_get()
+{
+  const int thread_index = tbb::this_task_arena::current_thread_index();
+  DCHECK_GE(thread_index, 0);
+  DCHECK_LT(thread_index, wavefront_states_.size());
+
+  unique_ptr<IntegratorStateCPU[]> &states = wavefront_states_[thread_index];
+  if (!states) {
+    /* Two states per path, for the split of shadow catcher paths. Not initialized, this is done
+     * by the init kernels. */
+    states.reset(new IntegratorStateCPU[WAVEFRONT_PATHS_NUM * 2]);
+  }
+  return states.get();
+}
+
+void PathTraceWorkCPU::render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                                IntegratorStateCPU *states,
+                                                const int64_t pixel_begin,
+                                                const int64_t pixel_end,
+                                                const int start_sample,
+                                                const int samples_num,
+                                                const int sample_offset)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+  const bool has_shadow_catcher = device_scene_->data.integrator.has_shadow_catcher;
+  const bool has_transparent_shadows = device_scene_->data.integrator.transparent_shadows;
+  const bool use_packets = DebugFlags().cpu.ray_packets;
+  /* The shadow catcher split writes into the state following the main path state. */
+  const int states_per_path = has_shadow_catcher ? 2 : 1;
+
+  const int64_t image_width = effective_buffer_params_.width;
+  const int64_t pixels_num = pixel_end - pixel_begin;
+  float *render_buffer = buffers_->buffer.data();
+
+  /* Pixels that do not need any more samples, as reported by the init kernels. */
+  vector<bool> pixel_done(pixels_num, false);
+  /* Whether a path is in flight for every slot of the batch. */
+  bool path_active[WAVEFRONT_PATHS_NUM] = {false};
+  int paths_active_num = 0;
+
+  /* Next work item to start a path for. All pixels are started for one sample before moving on to
+   * the next sample, so that paths in flight belong to neighbor pixels. */
+  int64_t next_pixel = 0;
+  int next_sample = 0;
+
+  /* Queued kernels of the paths in flight, as (sort key, state index). */
+  vector<std::pair<uint64_t, int>> queue;
+  queue.reserve(WAVEFRONT_PATHS_NUM * states_per_path);
+
+  while (true) {
+    /* Start new paths in the free slots, unless canceled in which case the paths in flight are
+     * still finished so that no partial samples are left in the render buffer. */
+    if (!is_cancel_requested()) {
+      for (int path = 0; path < WAVEFRONT_PATHS_NUM && next_sample < samples_num; path++) {
+        if (path_active[path]) {
+          continue;
+        }
+        IntegratorStateCPU *state = &states[path * states_per_path];
+
+        while (next_sample < samples_num) {
+          const int64_t pixel = next_pixel;
+          const int sample = next_sample;
+          if (++next_pixel == pixels_num) {
+            next_pixel = 0;
+            ++next_sample;
+          }
+          if (pixel_done[pixel]) {
+            continue;
+          }
+
+          const int64_t work_index = pixel_begin + pixel;
+          const int y = work_index / image_width;
+          const int x = work_index - y * image_width;
+
+          KernelWorkTile work_tile;
+          work_tile.x = effective_buffer_params_.full_x + x;
+          work_tile.y = effective_buffer_params_.full_y + y;
+          work_tile.w = 1;
+          work_tile.h = 1;
+          work_tile.start_sample = start_sample + sample;
+          work_tile.sample_offset = sample_offset;
+          work_tile.num_samples = 1;
+          work_tile.offset = effective_buffer_params_.offset;
+          work_tile.stride = effective_buffer_params_.stride;
+
+          if (has_shadow_catcher) {
+            path_state_init_queues(state + 1);
+          }
+
+          const bool is_started = has_bake ? kernels_.integrator_init_from_bake(
+                                                 kernel_globals, state, &work_tile, render_buffer) :
+                                             kernels_.integrator_init_from_camera(
+                                                 kernel_globals, state, &work_tile, render_buffer);
+          if (is_started) {
+            path_active[path] = true;
+            paths_active_num++;
+            break;
+          }
+
+          /* Same as the full pipeline, stop sampling the pixel once it was skipped. */
+          pixel_done[pixel] = true;
+        }
+      }
+    }
+
+    if (paths_active_num == 0) {
+      break;
+    }
+
+    /* Gather the queued kernels of all paths, and sort them by kernel and shader. */
+    queue.clear();
+    for (int path = 0; path < WAVEFRONT_PATHS_NUM; path++) {
+      if (!path_active[path]) {
+        continue;
+      }
+      for (int i = path * states_per_path; i < (path + 1) * states_per_path; i++) {
+        const IntegratorStateCPU &state = states[i];
+        if (state.path.queued_kernel) {
+          queue.emplace_back((uint64_t(state.path.queued_kernel) << 32) |
+                                 uint64_t(state.path.shader_sort_key),
+                             i);
+        }
+      }
+    }
+    std::sort(queue.begin(), queue.end());
+
+    /* Advance every path by one kernel. Camera rays of neighbor pixels are coherent and are
+     * intersected in packets, other kernels run one path at a time. */
+    IntegratorStateCPU *packet[RAY_PACKET_SIZE];
+    int packet_size = 0;
+    for (const std::pair<uint64_t, int> &item : queue) {
+      IntegratorStateCPU *state = &states[item.second];
+      if (use_packets && state->path.queued_kernel == DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST &&
+          state->path.bounce == 0)
+      {
+        packet[packet_size++] = state;
+        if (packet_size == RAY_PACKET_SIZE) {
+          kernels_.integrator_intersect_closest_packet(
+              kernel_globals, packet, packet_size, render_buffer);
+          packet_size = 0;
+        }
+        continue;
+      }
+      kernels_.integrator_megakernel_path_step(kernel_globals, state, render_buffer);
+    }
+    if (packet_size) {
+      kernels_.integrator_intersect_closest_packet(
+          kernel_globals, packet, packet_size, render_buffer);
+    }
+
+    /* Shadow rays towards the lights from the first hits are coherent as well. With transparent
+     * shadows every ray records its own intersections, so these are left to the megakernel. */
+    if (use_packets && !has_transparent_shadows) {
+      IntegratorShadowStateCPU *shadow_packet[RAY_PACKET_SIZE];
+      int shadow_packet_size = 0;
+      for (const std::pair<uint64_t, int> &item : queue) {
+        IntegratorStateCPU *state = &states[item.second];
+        for (IntegratorShadowStateCPU *shadow_state : {&state->shadow, &state->ao}) {
+          if (shadow_state->shadow_path.queued_kernel !=
+                  DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW ||
+              shadow_state->shadow_path.bounce != 0)
+          {
+            continue;
+          }
+          shadow_packet[shadow_packet_size++] = shadow_state;
+          if (shadow_packet_size == RAY_PACKET_SIZE) {
+            kernels_.integrator_intersect_shadow_packet(
+                kernel_globals, shadow_packet, shadow_packet_size);
+            shadow_packet_size = 0;
+          }
+        }
+      }
+      if (shadow_packet_size) {
+        kernels_.integrator_intersect_shadow_packet(
+            kernel_globals, shadow_packet, shadow_packet_size);
+      }
+    }
+
+    /* Trace the shadow rays created by these kernels, this needs to be done before the next
+     * kernel of the path may create new ones. */
+    for (const std::pair<uint64_t, int> &item : queue) {
+      kernels_.integrator_megakernel_shadow_paths(
+          kernel_globals, &states[item.second], render_buffer);
+    }
+
+    /* Free the slots of finished paths. */
+    for (int path = 0; path < WAVEFRONT_PATHS_NUM; path++) {
+      if (!path_active[path]) {
+        continue;
+      }
+      const IntegratorStateCPU *state = &states[path * states_per_path];
+      if (state->path.queued_kernel == 0 &&
+          (!has_shadow_catcher || state[1].path.queued_kernel == 0))
+      {
+        path_active[path] = false;
+        paths_active_num--;
+      }
+    }
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        int num_samples)
@@ -11,6 +11,7 @@
 
 #include "integrator/path_trace_work.h"
 
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -74,6 +75,23 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Wavefront path tracing routine. Renders all samples of the given range of pixels, keeping a
+   * batch of paths in flight and executing their kernels sorted by kernel and shader, so that
+   * consecutive kernel invocations access the same code and shader data. */
+  void render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                IntegratorStateCPU *states,
+                                const int64_t pixel_begin,
+                                const int64_t pixel_end,
+                                const int start_sample,
+                                const int samples_num,
+                                const int sample_offset);
+
+  /* Whether to use #render_samples_wavefront instead of #render_samples_full_pipeline. */
+  bool use_wavefront() const;
+
+  /* Get the states of the wavefront paths of the current thread, allocated on first use. */
+  IntegratorStateCPU *wavefront_states_get();
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -83,6 +101,9 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Per-thread integrator states of the paths in flight when using wavefront path tracing. */
+  vector<unique_ptr<IntegratorStateCPU[]>> wavefront_states_;
 };
 
 CCL_NAMESPACE_END
@@ -142,6 +142,47 @@ ccl_device_intersect bool scene_intersect_shadow(KernelGlobals kg,
   return scene_intersect(kg, ray, visibility, &isect);
 }
 
+#  ifdef __RAY_PACKETS__
+/* Intersect multiple rays at once, falling back to one ray at a time when the acceleration
+ * structure has no packet traversal. */
+ccl_device_intersect void scene_intersect_packet(KernelGlobals kg,
+                                                 ccl_private const Ray *rays,
+                                                 ccl_private const uint *visibility,
+                                                 ccl_private Intersection *isect,
+                                                 ccl_private bool *hit,
+                                                 const int num_rays)
+{
+#    ifdef __EMBREE_RAY_PACKETS__
+  if (kernel_data.device_bvh) {
+    kernel_embree_intersect_packet(kg, rays, visibility, isect, hit, num_rays);
+    return;
+  }
+#    endif
+
+  for (int i = 0; i < num_rays; i++) {
+    hit[i] = scene_intersect(kg, &rays[i], visibility[i], &isect[i]);
+  }
+}
+
+ccl_device_intersect void scene_intersect_shadow_packet(KernelGlobals kg,
+                                                        ccl_private const Ray *rays,
+                                                        ccl_private const uint *visibility,
+                                                        ccl_private bool *hit,
+                                                        const int num_rays)
+{
+#    ifdef __EMBREE_RAY_PACKETS__
+  if (kernel_data.device_bvh) {
+    kernel_embree_occluded_packet(kg, rays, visibility, hit, num_rays);
+    return;
+  }
+#    endif
+
+  for (int i = 0; i < num_rays; i++) {
+    hit[i] = scene_intersect_shadow(kg, &rays[i], visibility[i]);
+  }
+}
+#  endif
+
 /* Single object BVH traversal, for SSS/AO/bevel. */
 
 #  ifdef __BVH_LOCAL__
@@ -22,8 +22,12 @@ KERNEL_DATA_ARRAY(Transform, object_motion_pass)
 KERNEL_DATA_ARRAY(DecomposedTransform, object_motion)
 KERNEL_DATA_ARRAY(uint, object_flag)
 KERNEL_DATA_ARRAY(float, object_volume_step)
+KERNEL_DATA_ARRAY(int, object_volume_majorant)
 KERNEL_DATA_ARRAY(uint, object_prim_offset)
 
+/* volume majorant grids */
+KERNEL_DATA_ARRAY(float, volume_majorant)
+
 /* cameras */
 KERNEL_DATA_ARRAY(DecomposedTransform, camera_motion)
 
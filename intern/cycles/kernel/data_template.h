@@ -117,6 +117,8 @@ KERNEL_STRUCT_MEMBER(film, int, pass_cryptomatte)
 /* Adaptive sampling. */
 KERNEL_STRUCT_MEMBER(film, int, pass_adaptive_aux_buffer)
 KERNEL_STRUCT_MEMBER(film, int, pass_sample_count)
+/* Profiling. */
+KERNEL_STRUCT_MEMBER(film, int, pass_render_time)
 /* Mist. */
 KERNEL_STRUCT_MEMBER(film, int, pass_mist)
 KERNEL_STRUCT_MEMBER(film, float, mist_start)
@@ -203,6 +205,7 @@ KERNEL_STRUCT_MEMBER(integrator, int, blue_noise_sequence_length)
 KERNEL_STRUCT_MEMBER(integrator, int, use_volumes)
 KERNEL_STRUCT_MEMBER(integrator, int, volume_max_steps)
 KERNEL_STRUCT_MEMBER(integrator, float, volume_step_rate)
+KERNEL_STRUCT_MEMBER(integrator, int, use_volume_delta_tracking)
 /* Shadow catcher. */
 KERNEL_STRUCT_MEMBER(integrator, int, has_shadow_catcher)
 /* Closure filter. */
@@ -225,7 +228,6 @@ KERNEL_STRUCT_MEMBER(integrator, int, use_guiding_mis_weights)
 /* Padding. */
 KERNEL_STRUCT_MEMBER(integrator, int, pad1)
 KERNEL_STRUCT_MEMBER(integrator, int, pad2)
-KERNEL_STRUCT_MEMBER(integrator, int, pad3)
 KERNEL_STRUCT_END(KernelIntegrator)
 
 /* SVM. For shader specialization. */
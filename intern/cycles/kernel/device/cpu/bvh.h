@@ -52,6 +52,11 @@ using numhit_t = uint32_t;
 
 #define EMBREE_IS_HAIR(x) (x & 1)
 
+/* Packet ray queries are only implemented with the Embree 4 API. */
+#if defined(__RAY_PACKETS__) && EMBREE_MAJOR_VERSION >= 4
+#  define __EMBREE_RAY_PACKETS__
+#endif
+
 #if EMBREE_MAJOR_VERSION < 4
 #  define rtcGetGeometryUserDataFromScene(scene, id) \
     (rtcGetGeometryUserData(rtcGetGeometry(scene, id)))
@@ -65,7 +70,8 @@ struct CCLFirstHitContext
 #endif
 {
   KernelGlobals kg;
-  /* For avoiding self intersections */
+  /* For avoiding self intersections. For packet queries this is an array of rays, indexed by the
+   * ID of the Embree ray. */
   const Ray *ray;
 };
 
@@ -171,6 +177,27 @@ ccl_device_inline void kernel_embree_setup_ray(const Ray &ray,
   rtc_ray.mask = visibility;
 }
 
+#ifdef __EMBREE_RAY_PACKETS__
+ccl_device_inline void kernel_embree_setup_ray8(const Ray &ray,
+                                                RTCRay8 &rtc_ray,
+                                                const int i,
+                                                const uint visibility)
+{
+  rtc_ray.org_x[i] = ray.P.x;
+  rtc_ray.org_y[i] = ray.P.y;
+  rtc_ray.org_z[i] = ray.P.z;
+  rtc_ray.dir_x[i] = ray.D.x;
+  rtc_ray.dir_y[i] = ray.D.y;
+  rtc_ray.dir_z[i] = ray.D.z;
+  rtc_ray.tnear[i] = ray.tmin;
+  rtc_ray.tfar[i] = ray.tmax;
+  rtc_ray.time[i] = ray.time;
+  rtc_ray.mask[i] = visibility;
+  rtc_ray.id[i] = i;
+  rtc_ray.flags[i] = 0;
+}
+#endif
+
 ccl_device_inline void kernel_embree_setup_rayhit(const Ray &ray,
                                                   RTCRayHit &rayhit,
                                                   const uint visibility)
@@ -271,10 +298,48 @@ ccl_device_inline void kernel_embree_convert_sss_hit(KernelGlobals kg,
  * Things like recording subsurface or shadow hits for later evaluation
  * as well as filtering for volume objects happen here.
  * Cycles' own BVH does that directly inside the traversal calls. */
+#ifdef __EMBREE_RAY_PACKETS__
+ccl_device_forceinline void kernel_embree_filter_intersection_packet_func_impl(
+    const RTCFilterFunctionNArguments *args)
+{
+  const CCLFirstHitContext *ctx = (const CCLFirstHitContext *)(args->context);
+  const KernelGlobalsCPU *kg = ctx->kg;
+  const intptr_t prim_offset = reinterpret_cast<intptr_t>(args->geometryUserPtr);
+
+  for (uint i = 0; i < args->N; i++) {
+    if (args->valid[i] == 0) {
+      continue;
+    }
+
+    RTCHit hit = rtcGetHitFromHitN(args->hit, args->N, i);
+    const Ray *cray = ctx->ray + RTCRayN_id(args->ray, args->N, i);
+
+    if (kernel_embree_is_self_intersection(kg, &hit, cray, prim_offset)) {
+      args->valid[i] = 0;
+      continue;
+    }
+
+#  ifdef __SHADOW_LINKING__
+    if (intersection_skip_shadow_link(kg, cray->self, kernel_embree_get_hit_object(&hit))) {
+      args->valid[i] = 0;
+      continue;
+    }
+#  endif
+  }
+}
+#endif
+
 ccl_device_forceinline void kernel_embree_filter_intersection_func_impl(
     const RTCFilterFunctionNArguments *args)
 {
-  /* Current implementation in Cycles assumes only single-ray intersection queries. */
+#ifdef __EMBREE_RAY_PACKETS__
+  if (args->N > 1) {
+    kernel_embree_filter_intersection_packet_func_impl(args);
+    return;
+  }
+#endif
+
+  /* Other than packets of first hit rays, Cycles only uses single-ray intersection queries. */
   assert(args->N == 1);
 
   RTCHit *hit = (RTCHit *)args->hit;
@@ -758,6 +823,89 @@ ccl_device_intersect bool kernel_embree_intersect(KernelGlobals kg,
   return true;
 }
 
+#ifdef __EMBREE_RAY_PACKETS__
+/* Find the closest hit of up to 8 rays at once. Coherent rays, like camera rays of neighbor
+ * pixels, traverse the BVH together which is faster than tracing them one by one. */
+ccl_device_intersect void kernel_embree_intersect_packet(KernelGlobals kg,
+                                                         ccl_private const Ray *rays,
+                                                         ccl_private const uint *visibility,
+                                                         ccl_private Intersection *isect,
+                                                         ccl_private bool *hit,
+                                                         const int num_rays)
+{
+  CCLFirstHitContext ctx;
+  rtcInitRayQueryContext(&ctx);
+  ctx.kg = kg;
+  ctx.ray = rays;
+
+  int valid[8];
+  RTCRayHit8 ray_hit;
+  for (int i = 0; i < 8; i++) {
+    valid[i] = (i < num_rays && intersection_ray_valid(&rays[i])) ? -1 : 0;
+    if (valid[i]) {
+      isect[i].t = rays[i].tmax;
+      kernel_embree_setup_ray8(rays[i], ray_hit.ray, i, visibility[i]);
+      ray_hit.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+      ray_hit.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+    }
+  }
+
+  RTCIntersectArguments args;
+  rtcInitIntersectArguments(&args);
+  args.flags = RTC_RAY_QUERY_FLAG_COHERENT;
+  args.filter = reinterpret_cast<RTCFilterFunctionN>(kernel_embree_filter_intersection_func);
+  args.feature_mask = CYCLES_EMBREE_USED_FEATURES;
+  args.context = &ctx;
+  rtcIntersect8(valid, kernel_data.device_bvh, &ray_hit, &args);
+
+  for (int i = 0; i < num_rays; i++) {
+    hit[i] = valid[i] && ray_hit.hit.geomID[i] != RTC_INVALID_GEOMETRY_ID &&
+             ray_hit.hit.primID[i] != RTC_INVALID_GEOMETRY_ID;
+    if (hit[i]) {
+      RTCRay rtc_ray = rtcGetRayFromRayN((RTCRayN *)&ray_hit.ray, 8, i);
+      RTCHit rtc_hit = rtcGetHitFromHitN((RTCHitN *)&ray_hit.hit, 8, i);
+      kernel_embree_convert_hit(kg, &rtc_ray, &rtc_hit, &isect[i]);
+    }
+  }
+}
+
+/* Test up to 8 rays for any hit at once. */
+ccl_device_intersect void kernel_embree_occluded_packet(KernelGlobals kg,
+                                                        ccl_private const Ray *rays,
+                                                        ccl_private const uint *visibility,
+                                                        ccl_private bool *hit,
+                                                        const int num_rays)
+{
+  CCLFirstHitContext ctx;
+  rtcInitRayQueryContext(&ctx);
+  ctx.kg = kg;
+  ctx.ray = rays;
+
+  int valid[8];
+  RTCRay8 rtc_ray;
+  for (int i = 0; i < 8; i++) {
+    valid[i] = (i < num_rays && intersection_ray_valid(&rays[i])) ? -1 : 0;
+    if (valid[i]) {
+      kernel_embree_setup_ray8(rays[i], rtc_ray, i, visibility[i]);
+    }
+  }
+
+  /* Only self intersections and shadow linking need filtering, same as for first hit rays. */
+  RTCOccludedArguments args;
+  rtcInitOccludedArguments(&args);
+  args.flags = RTC_RAY_QUERY_FLAG_COHERENT;
+  args.filter = reinterpret_cast<RTCFilterFunctionN>(kernel_embree_filter_intersection_func);
+  args.feature_mask = CYCLES_EMBREE_USED_FEATURES;
+  args.context = &ctx;
+  rtcOccluded8(valid, kernel_data.device_bvh, &rtc_ray, &args);
+
+  /* rtcOccluded8 sets tfar to -inf if a hit was found. */
+  for (int i = 0; i < num_rays; i++) {
+    hit[i] = valid[i] && rtc_ray.tfar[i] < 0.0f;
+  }
+}
+#endif
+
 #ifdef __BVH_LOCAL__
 ccl_device_intersect bool kernel_embree_intersect_local(KernelGlobals kg,
                                                         ccl_private const Ray *ray,
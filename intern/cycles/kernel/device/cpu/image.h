@@ -844,6 +844,10 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE: {
+      const TextureCacheImage *image = *(const TextureCacheImage *const *)info.data;
+      return image->lookup(x, y, zero_float2(), zero_float2());
+    }
     default:
       assert(0);
       return make_float4(
@@ -851,6 +855,21 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
   }
 }
 
+/* Lookup with texture coordinate derivatives, used to choose the mip level of images sampled
+ * through the texture cache. Other images ignore the derivatives. */
+ccl_device float4 kernel_tex_image_interp_filtered(
+    KernelGlobals kg, int id, float x, float y, float2 dx, float2 dy)
+{
+  const TextureInfo &info = kernel_data_fetch(texture_info, id);
+
+  if (info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE && info.data) {
+    const TextureCacheImage *image = *(const TextureCacheImage *const *)info.data;
+    return image->lookup(x, y, dx, dy);
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              int id,
                                              float3 P,
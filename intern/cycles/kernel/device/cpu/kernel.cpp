@@ -36,6 +36,10 @@
 #    endif
 #    define __KERNEL_AVX2__
 #  endif
+#  if defined(__AVX512F__) && defined(__AVX512CD__) && defined(__AVX512DQ__) && \
+      defined(__AVX512BW__) && defined(__AVX512VL__)
+#    define __KERNEL_AVX512__
+#  endif
 #endif
 
 /* quiet unused define warnings */
@@ -18,6 +18,7 @@ CCL_NAMESPACE_BEGIN
 #define KERNEL_FUNCTION_FULL_NAME(name) KERNEL_NAME_EVAL(KERNEL_ARCH, name)
 
 struct IntegratorStateCPU;
+struct IntegratorShadowStateCPU;
 struct KernelGlobalsCPU;
 struct KernelData;
 
@@ -39,4 +40,7 @@ void kernel_global_memory_copy(KernelGlobalsCPU *kg, const char *name, void *mem
 #define KERNEL_ARCH cpu_avx2
 #include "kernel/device/cpu/kernel_arch.h"
 
+#define KERNEL_ARCH cpu_avx512
+#include "kernel/device/cpu/kernel_arch.h"
+
 CCL_NAMESPACE_END
@@ -23,6 +23,17 @@
                                                     KernelWorkTile *tile, \
                                                     ccl_global float *render_buffer)
 
+#define KERNEL_INTEGRATOR_PACKET_FUNCTION(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const KernelGlobalsCPU *ccl_restrict kg, \
+                                                    IntegratorStateCPU *const *states, \
+                                                    const int num_states, \
+                                                    ccl_global float *render_buffer)
+
+#define KERNEL_INTEGRATOR_SHADOW_PACKET_FUNCTION(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const KernelGlobalsCPU *ccl_restrict kg, \
+                                                    IntegratorShadowStateCPU *const *states, \
+                                                    const int num_states)
+
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_camera);
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_bake);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(intersect_closest);
@@ -37,10 +48,16 @@ KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_surface);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_volume);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_dedicated_light);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel_path_step);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel_shadow_paths);
+KERNEL_INTEGRATOR_PACKET_FUNCTION(intersect_closest_packet);
+KERNEL_INTEGRATOR_SHADOW_PACKET_FUNCTION(intersect_shadow_packet);
 
 #undef KERNEL_INTEGRATOR_FUNCTION
 #undef KERNEL_INTEGRATOR_INIT_FUNCTION
 #undef KERNEL_INTEGRATOR_SHADE_FUNCTION
+#undef KERNEL_INTEGRATOR_PACKET_FUNCTION
+#undef KERNEL_INTEGRATOR_SHADOW_PACKET_FUNCTION
 
 #define KERNEL_FILM_CONVERT_FUNCTION(name) \
   void KERNEL_FUNCTION_FULL_NAME(film_convert_##name)(const KernelFilmConvert *kfilm_convert, \
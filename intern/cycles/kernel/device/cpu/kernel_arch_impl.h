@@ -98,6 +98,23 @@ CCL_NAMESPACE_BEGIN
     KERNEL_INVOKE(name, kg, &state->shadow, render_buffer); \
   }
 
+#define DEFINE_INTEGRATOR_PACKET_KERNEL(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const KernelGlobalsCPU *kg, \
+                                                    IntegratorStateCPU *const *states, \
+                                                    const int num_states, \
+                                                    ccl_global float *render_buffer) \
+  { \
+    KERNEL_INVOKE(name, kg, states, num_states, render_buffer); \
+  }
+
+#define DEFINE_INTEGRATOR_SHADOW_PACKET_KERNEL(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name)(const KernelGlobalsCPU *kg, \
+                                                    IntegratorShadowStateCPU *const *states, \
+                                                    const int num_states) \
+  { \
+    KERNEL_INVOKE(name, kg, states, num_states); \
+  }
+
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_camera)
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_bake)
 DEFINE_INTEGRATOR_SHADE_KERNEL(intersect_closest)
@@ -110,8 +127,12 @@ DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_volume)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_dedicated_light)
 DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
+DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel_path_step)
+DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel_shadow_paths)
 DEFINE_INTEGRATOR_SHADOW_KERNEL(intersect_shadow)
 DEFINE_INTEGRATOR_SHADOW_SHADE_KERNEL(shade_shadow)
+DEFINE_INTEGRATOR_PACKET_KERNEL(intersect_closest_packet)
+DEFINE_INTEGRATOR_SHADOW_PACKET_KERNEL(intersect_shadow_packet)
 
 /* --------------------------------------------------------------------
  * Shader evaluation.
@@ -305,6 +326,8 @@ KERNEL_FILM_CONVERT_FUNCTION(float4, false)
 #undef DEFINE_INTEGRATOR_KERNEL
 #undef DEFINE_INTEGRATOR_SHADE_KERNEL
 #undef DEFINE_INTEGRATOR_INIT_KERNEL
+#undef DEFINE_INTEGRATOR_PACKET_KERNEL
+#undef DEFINE_INTEGRATOR_SHADOW_PACKET_KERNEL
 
 #undef KERNEL_STUB
 #undef STUB_ASSERT
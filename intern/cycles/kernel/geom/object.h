@@ -401,6 +401,17 @@ ccl_device_inline float object_volume_step_size(KernelGlobals kg, int object)
   return kernel_data_fetch(object_volume_step, object);
 }
 
+/* Offset of volume majorant grid, or -1 if the object has none. */
+
+ccl_device_inline int object_volume_majorant_offset(KernelGlobals kg, int object)
+{
+  if (object == OBJECT_NONE) {
+    return -1;
+  }
+
+  return kernel_data_fetch(object_volume_majorant, object);
+}
+
 /* Pass ID for shader */
 
 ccl_device int shader_pass_id(KernelGlobals kg, ccl_private const ShaderData *sd)
@@ -80,6 +80,115 @@ ccl_device float4 volume_attribute_float4(KernelGlobals kg,
   }
 }
 
+/* Volume Majorant Grid
+ *
+ * Upper bound of the extinction per cell of a regular grid in object space, used for delta
+ * tracking. The grid starts with a header of VOLUME_MAJORANT_HEADER_SIZE floats: resolution,
+ * bounds minimum, inverse cell size and whether the shader has emission. */
+
+ccl_device_inline void volume_majorant_grid_slab(const float P,
+                                                 const float D,
+                                                 const float size,
+                                                 ccl_private float *t_enter,
+                                                 ccl_private float *t_exit)
+{
+  if (D != 0.0f) {
+    const float t0 = -P / D;
+    const float t1 = (size - P) / D;
+    *t_enter = fmaxf(*t_enter, fminf(t0, t1));
+    *t_exit = fminf(*t_exit, fmaxf(t0, t1));
+  }
+  else if (P < 0.0f || P > size) {
+    *t_exit = -FLT_MAX;
+  }
+}
+
+ccl_device_inline float volume_majorant_grid_cell_exit(const float P,
+                                                       const float D,
+                                                       const int cell)
+{
+  if (D > 0.0f) {
+    return ((float)(cell + 1) - P) / D;
+  }
+  else if (D < 0.0f) {
+    return ((float)cell - P) / D;
+  }
+  return FLT_MAX;
+}
+
+/* Majorant at distance t along the ray, and the distance at which it next changes.
+ * The emission of the volume is sampled at least every `min_emission_step_size`. */
+ccl_device float volume_majorant_grid(KernelGlobals kg,
+                                      const int object,
+                                      const int offset,
+                                      const float3 ray_P,
+                                      const float3 ray_D,
+                                      const float time,
+                                      const float t,
+                                      const float min_emission_step_size,
+                                      ccl_private float *t_next)
+{
+  const float3 resolution = make_float3(kernel_data_fetch(volume_majorant, offset + 0),
+                                        kernel_data_fetch(volume_majorant, offset + 1),
+                                        kernel_data_fetch(volume_majorant, offset + 2));
+  const float3 bounds_min = make_float3(kernel_data_fetch(volume_majorant, offset + 3),
+                                        kernel_data_fetch(volume_majorant, offset + 4),
+                                        kernel_data_fetch(volume_majorant, offset + 5));
+  const float3 inv_cell_size = make_float3(kernel_data_fetch(volume_majorant, offset + 6),
+                                           kernel_data_fetch(volume_majorant, offset + 7),
+                                           kernel_data_fetch(volume_majorant, offset + 8));
+  const bool has_emission = kernel_data_fetch(volume_majorant, offset + 9) != 0.0f;
+
+  /* Ray in grid space, where cells have unit size. Distances along the ray are unchanged. */
+  Transform itfm;
+  object_fetch_transform_motion_test(kg, object, time, &itfm);
+  const float3 P = (transform_point(&itfm, ray_P) - bounds_min) * inv_cell_size;
+  const float3 D = transform_direction(&itfm, ray_D) * inv_cell_size;
+
+  float t_enter = -FLT_MAX, t_exit = FLT_MAX;
+  volume_majorant_grid_slab(P.x, D.x, resolution.x, &t_enter, &t_exit);
+  volume_majorant_grid_slab(P.y, D.y, resolution.y, &t_enter, &t_exit);
+  volume_majorant_grid_slab(P.z, D.z, resolution.z, &t_enter, &t_exit);
+
+  if (t_enter > t_exit || t >= t_exit) {
+    /* Ray does not pass through the grid anymore. */
+    *t_next = FLT_MAX;
+    return 0.0f;
+  }
+  else if (t < t_enter) {
+    /* Ray enters the grid later. */
+    *t_next = t_enter;
+    return 0.0f;
+  }
+
+  const int3 res = make_int3((int)resolution.x, (int)resolution.y, (int)resolution.z);
+  const float3 P_t = P + t * D;
+  const int x = clamp((int)floorf(P_t.x), 0, res.x - 1);
+  const int y = clamp((int)floorf(P_t.y), 0, res.y - 1);
+  const int z = clamp((int)floorf(P_t.z), 0, res.z - 1);
+
+  *t_next = fminf(t_exit,
+                  fminf(volume_majorant_grid_cell_exit(P.x, D.x, x),
+                        fminf(volume_majorant_grid_cell_exit(P.y, D.y, y),
+                              volume_majorant_grid_cell_exit(P.z, D.z, z))));
+
+  float majorant = kernel_data_fetch(volume_majorant,
+                                     offset + VOLUME_MAJORANT_HEADER_SIZE + x +
+                                         res.x * (y + res.y * z));
+  majorant *= fmaxf(object_volume_density(kg, object), 0.0f);
+
+  if (has_emission) {
+    /* Emission does not depend on the extinction, so sample collisions at least as often as
+     * the ray marching step size to pick it up. */
+    const float step_size = fmaxf(
+        object_volume_step_size(kg, object) * kernel_data.integrator.volume_step_rate,
+        min_emission_step_size);
+    majorant = fmaxf(majorant, 1.0f / step_size);
+  }
+
+  return majorant;
+}
+
 #endif
 
 CCL_NAMESPACE_END
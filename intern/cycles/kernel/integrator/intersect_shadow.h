@@ -20,10 +20,8 @@ ccl_device_forceinline uint integrate_intersect_shadow_visibility(KernelGlobals
   return visibility;
 }
 
-ccl_device bool integrate_intersect_shadow_opaque(KernelGlobals kg,
-                                                  IntegratorShadowState state,
-                                                  ccl_private const Ray *ray,
-                                                  const uint visibility)
+/* Visibility for intersecting only opaque objects with the shadow ray. */
+ccl_device_forceinline uint integrate_intersect_shadow_opaque_visibility(const uint visibility)
 {
   /* Mask which will pick only opaque visibility bits from the `visibility`.
    * Calculate the mask at compile time: the visibility will either be a high bits for the shadow
@@ -32,14 +30,30 @@ ccl_device bool integrate_intersect_shadow_opaque(KernelGlobals kg,
   constexpr const uint opaque_mask = SHADOW_CATCHER_VISIBILITY_SHIFT(PATH_RAY_SHADOW_OPAQUE) |
                                      PATH_RAY_SHADOW_OPAQUE;
 
-  const bool opaque_hit = scene_intersect_shadow(kg, ray, visibility & opaque_mask);
+  return visibility & opaque_mask;
+}
 
+/* Record the result of intersecting only opaque objects with the shadow ray. */
+ccl_device_forceinline void integrate_intersect_shadow_opaque_record(IntegratorShadowState state,
+                                                                     const bool opaque_hit)
+{
   /* Only record the number of hits if nothing was hit, so that the shadow shading kernel does not
    * consider any intersections. There is no need to write anything to the state if the hit is
    * opaque because in this case the path is terminated. */
   if (!opaque_hit) {
     INTEGRATOR_STATE_WRITE(state, shadow_path, num_hits) = 0;
   }
+}
+
+ccl_device bool integrate_intersect_shadow_opaque(KernelGlobals kg,
+                                                  IntegratorShadowState state,
+                                                  ccl_private const Ray *ray,
+                                                  const uint visibility)
+{
+  const bool opaque_hit = scene_intersect_shadow(
+      kg, ray, integrate_intersect_shadow_opaque_visibility(visibility));
+
+  integrate_intersect_shadow_opaque_record(state, opaque_hit);
 
   return opaque_hit;
 }
@@ -140,6 +154,30 @@ ccl_device bool integrate_intersect_shadow_transparent(KernelGlobals kg,
 }
 #endif
 
+/* Queue the next shadow kernel depending on whether an opaque surface was hit. */
+ccl_device_forceinline void integrator_intersect_shadow_finish(KernelGlobals kg,
+                                                               IntegratorShadowState state,
+                                                               const bool opaque_hit)
+{
+  if (opaque_hit) {
+    /* Hit an opaque surface, shadow path ends here. */
+    integrator_shadow_path_terminate(kg, state, DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW);
+    return;
+  }
+  else {
+    /* Hit nothing or transparent surfaces, continue to shadow kernel
+     * for shading and render buffer output.
+     *
+     * TODO: could also write to render buffer directly if no transparent shadows?
+     * Could save a kernel execution for the common case. */
+    integrator_shadow_path_next(kg,
+                                state,
+                                DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW,
+                                DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW);
+    return;
+  }
+}
+
 ccl_device void integrator_intersect_shadow(KernelGlobals kg, IntegratorShadowState state)
 {
   PROFILING_INIT(kg, PROFILING_INTERSECT_SHADOW);
@@ -161,23 +199,39 @@ ccl_device void integrator_intersect_shadow(KernelGlobals kg, IntegratorShadowSt
   const bool opaque_hit = integrate_intersect_shadow_opaque(kg, state, &ray, visibility);
 #endif
 
-  if (opaque_hit) {
-    /* Hit an opaque surface, shadow path ends here. */
-    integrator_shadow_path_terminate(kg, state, DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW);
-    return;
+  integrator_intersect_shadow_finish(kg, state, opaque_hit);
+}
+
+#ifdef __RAY_PACKETS__
+/* Intersect the rays of multiple shadow paths at once. Only opaque shadows are supported, with
+ * transparent shadows every ray records its own list of hits and is intersected separately. */
+ccl_device void integrator_intersect_shadow_packet(KernelGlobals kg,
+                                                   IntegratorShadowState const *states,
+                                                   const int num_states)
+{
+  PROFILING_INIT(kg, PROFILING_INTERSECT_SHADOW);
+
+  kernel_assert(num_states <= RAY_PACKET_SIZE);
+
+  /* Same as integrate_intersect_shadow_opaque, for all rays at once. */
+  Ray rays[RAY_PACKET_SIZE];
+  uint visibility[RAY_PACKET_SIZE];
+  bool opaque_hit[RAY_PACKET_SIZE];
+
+  for (int i = 0; i < num_states; i++) {
+    integrator_state_read_shadow_ray(states[i], &rays[i]);
+    integrator_state_read_shadow_ray_self(kg, states[i], &rays[i]);
+    visibility[i] = integrate_intersect_shadow_opaque_visibility(
+        integrate_intersect_shadow_visibility(kg, states[i]));
   }
-  else {
-    /* Hit nothing or transparent surfaces, continue to shadow kernel
-     * for shading and render buffer output.
-     *
-     * TODO: could also write to render buffer directly if no transparent shadows?
-     * Could save a kernel execution for the common case. */
-    integrator_shadow_path_next(kg,
-                                state,
-                                DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW,
-                                DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW);
-    return;
+
+  scene_intersect_shadow_packet(kg, rays, visibility, opaque_hit, num_states);
+
+  for (int i = 0; i < num_states; i++) {
+    integrate_intersect_shadow_opaque_record(states[i], opaque_hit[i]);
+    integrator_intersect_shadow_finish(kg, states[i], opaque_hit[i]);
   }
 }
+#endif
 
 CCL_NAMESPACE_END
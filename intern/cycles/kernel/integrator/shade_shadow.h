@@ -93,7 +93,12 @@ ccl_device_inline void integrate_transparent_volume_shadow(KernelGlobals kg,
   VOLUME_READ_LAMBDA(integrator_state_read_shadow_volume_stack(state, i));
   const float step_size = volume_stack_step_size(kg, volume_read_lambda_pass);
 
-  volume_shadow_heterogeneous(kg, state, &ray, shadow_sd, throughput, step_size);
+  if (step_size != FLT_MAX && volume_stack_has_majorant(kg, volume_read_lambda_pass)) {
+    volume_shadow_tracking(kg, state, &ray, shadow_sd, throughput, step_size);
+  }
+  else {
+    volume_shadow_heterogeneous(kg, state, &ray, shadow_sd, throughput, step_size);
+  }
 }
 #  endif
 
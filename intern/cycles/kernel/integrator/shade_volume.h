@@ -253,6 +253,109 @@ ccl_device void volume_shadow_heterogeneous(KernelGlobals kg,
   *throughput = tp;
 }
 
+/* Delta Tracking
+ *
+ * Instead of ray marching, sample tentative collisions with a majorant of the extinction that
+ * is piecewise constant along the ray, given by the majorant grids of the volumes in the stack.
+ * Null collisions where the actual extinction is lower are skipped, so that only the density
+ * at the collisions is evaluated, without bias from the step size. */
+
+/* Advance to the next tentative collision, stepping through cells of the majorant grids where
+ * no collision occurs. Returns false when reaching the end of the ray or the step limit, the
+ * latter can be detected with #volume_tracking_out_of_steps. */
+template<typename StackReadOp>
+ccl_device_forceinline bool volume_tracking_next_collision(KernelGlobals kg,
+                                                           ccl_private const Ray *ccl_restrict
+                                                               ray,
+                                                           StackReadOp stack_read,
+                                                           ccl_private RNGState *rng_state,
+                                                           ccl_private float *t,
+                                                           ccl_private float *t_next,
+                                                           ccl_private float *majorant,
+                                                           ccl_private int *steps)
+{
+  const int max_steps = kernel_data.integrator.volume_max_steps;
+
+  while ((*steps)++ < max_steps) {
+    if (*t >= *t_next) {
+      /* Entering a new cell, ensure progress in case of precision issues at the boundary. */
+      *majorant = volume_stack_majorant(kg, ray, *t, stack_read, t_next);
+      *t_next = fminf(fmaxf(*t_next, *t + 1e-5f * (ray->tmax - ray->tmin)), ray->tmax);
+    }
+
+    /* Use new random numbers for every step, they are independent from the previous ones. */
+    rng_state->rng_offset += PRNG_BOUNCE_NUM;
+    const float rand = path_state_rng_1D(kg, rng_state, PRNG_VOLUME_SCATTER_DISTANCE);
+    const float dt = (*majorant > 0.0f) ? -logf(1.0f - rand) / *majorant : FLT_MAX;
+
+    if (*t + dt < *t_next) {
+      *t += dt;
+      return true;
+    }
+
+    /* No collision within this cell, continue from the boundary since the exponential
+     * distribution is memoryless. */
+    *t = *t_next;
+    if (*t >= ray->tmax) {
+      break;
+    }
+  }
+
+  return false;
+}
+
+ccl_device_forceinline bool volume_tracking_out_of_steps(KernelGlobals kg, const int steps)
+{
+  return steps > kernel_data.integrator.volume_max_steps;
+}
+
+/* Ratio tracking for shadows: attenuate by the probability of each tentative collision being a
+ * null collision. */
+ccl_device void volume_shadow_tracking(KernelGlobals kg,
+                                       IntegratorShadowState state,
+                                       ccl_private Ray *ccl_restrict ray,
+                                       ccl_private ShaderData *ccl_restrict sd,
+                                       ccl_private Spectrum *ccl_restrict throughput,
+                                       const float object_step_size)
+{
+  /* Load random number state, decorrelated from the rest of the path. */
+  RNGState rng_state;
+  shadow_path_state_rng_load(state, &rng_state);
+  path_state_rng_scramble(&rng_state, 0x1d3f6e57);
+
+  VOLUME_READ_LAMBDA(integrator_state_read_shadow_volume_stack(state, i))
+
+  Spectrum tp = *throughput;
+  float t = ray->tmin, t_next = ray->tmin, majorant = 0.0f;
+  int steps = 0;
+
+  while (volume_tracking_next_collision(
+      kg, ray, volume_read_lambda_pass, &rng_state, &t, &t_next, &majorant, &steps))
+  {
+    sd->P = ray->P + ray->D * t;
+
+    Spectrum sigma_t = zero_spectrum();
+    if (shadow_volume_shader_sample(kg, state, sd, &sigma_t)) {
+      tp *= one_spectrum() - sigma_t / majorant;
+
+      /* Stop if nearly all light is blocked. */
+      if (reduce_max(fabs(tp)) < VOLUME_THROUGHPUT_EPSILON) {
+        break;
+      }
+    }
+  }
+
+  if (volume_tracking_out_of_steps(kg, steps)) {
+    /* Ray march the rest of the segment, with the step size widened to fit the step limit, so
+     * that light does not pass through it unattenuated. */
+    Ray remaining_ray = *ray;
+    remaining_ray.tmin = t;
+    volume_shadow_heterogeneous(kg, state, &remaining_ray, sd, &tp, object_step_size);
+  }
+
+  *throughput = tp;
+}
+
 /* Equi-angular sampling as in:
  * "Importance Sampling Techniques for Path Tracing in Participating Media" */
 
@@ -650,6 +753,133 @@ ccl_device_forceinline void volume_integrate_heterogeneous(
 #  endif /* __DENOISING_FEATURES__ */
 }
 
+/* Spectral tracking: decide between scattering and null collision at each tentative collision,
+ * with probabilities proportional to the throughput weighted coefficients of all channels.
+ * Direct light is sampled at the same position as indirect light. */
+ccl_device_forceinline void volume_integrate_heterogeneous_tracking(
+    KernelGlobals kg,
+    IntegratorState state,
+    ccl_private Ray *ccl_restrict ray,
+    ccl_private ShaderData *ccl_restrict sd,
+    ccl_private const RNGState *rng_state,
+    ccl_global float *ccl_restrict render_buffer,
+    ccl_private VolumeIntegrateResult &result)
+{
+  PROFILING_INIT(kg, PROFILING_SHADE_VOLUME_INTEGRATE);
+
+  /* Random numbers for collisions, decorrelated from the rest of the path. */
+  RNGState collision_rng_state = *rng_state;
+  path_state_rng_scramble(&collision_rng_state, 0x6c8e9cf5);
+
+  /* Initialize volume integration result. */
+  const Spectrum throughput = INTEGRATOR_STATE(state, path, throughput);
+  result.direct_throughput = throughput;
+  result.indirect_throughput = throughput;
+#  ifdef __PATH_GUIDING__
+  result.direct_sample_method = VOLUME_SAMPLE_DISTANCE;
+#  endif
+
+#  ifdef __DENOISING_FEATURES__
+  const bool write_denoising_features = (INTEGRATOR_STATE(state, path, flag) &
+                                         PATH_RAY_DENOISING_FEATURES);
+  Spectrum accum_albedo = zero_spectrum();
+#  endif
+  Spectrum accum_emission = zero_spectrum();
+
+  VOLUME_READ_LAMBDA(integrator_state_read_volume_stack(state, i))
+
+  float t = ray->tmin, t_next = ray->tmin, majorant = 0.0f;
+  int steps = 0;
+
+  while (volume_tracking_next_collision(
+      kg, ray, volume_read_lambda_pass, &collision_rng_state, &t, &t_next, &majorant, &steps))
+  {
+    sd->P = ray->P + ray->D * t;
+
+    VolumeShaderCoefficients coeff ccl_optional_struct_init;
+    if (!volume_shader_sample(kg, state, sd, &coeff)) {
+      /* Null collision with unchanged throughput. */
+      continue;
+    }
+
+    const int closure_flag = sd->flag;
+
+    /* Emission, estimated at every tentative collision. */
+    if (closure_flag & SD_EMISSION) {
+      const Spectrum emission = coeff.emission / majorant;
+      accum_emission += result.indirect_throughput * emission;
+      guiding_record_volume_emission(kg, state, emission);
+    }
+
+    const Spectrum sigma_s = (closure_flag & SD_SCATTER) ? coeff.sigma_s : zero_spectrum();
+    const Spectrum sigma_n = make_spectrum(majorant) - coeff.sigma_t;
+
+#  ifdef __DENOISING_FEATURES__
+    /* Accumulate albedo for denoising features. */
+    if (write_denoising_features) {
+      accum_albedo += result.indirect_throughput * sigma_s / majorant;
+    }
+#  endif
+
+    /* Pick scattering or null collision. Absorption is accounted for in the weights, and the
+     * null collision weight may be negative where the majorant does not bound the extinction. */
+    const float p_scatter = reduce_add(fabs(result.indirect_throughput * sigma_s));
+    const float p_null = reduce_add(fabs(result.indirect_throughput * sigma_n));
+    const float p_sum = p_scatter + p_null;
+
+    if (p_sum == 0.0f) {
+      result.indirect_throughput = zero_spectrum();
+      break;
+    }
+
+    const float rand = path_state_rng_1D(kg, &collision_rng_state, PRNG_VOLUME_COLOR_CHANNEL);
+
+    if (rand * p_sum < p_scatter) {
+      result.indirect_scatter = true;
+      result.indirect_t = t;
+      result.indirect_throughput *= sigma_s * (p_sum / (majorant * p_scatter));
+      volume_shader_copy_phases(&result.indirect_phases, sd);
+
+      result.direct_scatter = true;
+      result.direct_t = t;
+      result.direct_throughput = result.indirect_throughput;
+      volume_shader_copy_phases(&result.direct_phases, sd);
+      break;
+    }
+
+    result.indirect_throughput *= sigma_n * (p_sum / (majorant * p_null));
+
+    /* Stop if nearly all light blocked. */
+    if (reduce_max(fabs(result.indirect_throughput)) < VOLUME_THROUGHPUT_EPSILON) {
+      result.indirect_throughput = zero_spectrum();
+      break;
+    }
+  }
+
+  if (volume_tracking_out_of_steps(kg, steps)) {
+    /* Terminate the path when running out of steps before the end of the segment, instead of
+     * letting light pass through the rest of the volume unattenuated. The emission step size is
+     * widened to fit the step limit, so this only happens with exceptionally many collisions. */
+    result.indirect_throughput = zero_spectrum();
+  }
+
+  /* Write accumulated emission. */
+  if (!is_zero(accum_emission)) {
+    if (light_link_object_match(kg, light_link_receiver_forward(kg, state), sd->object)) {
+      film_write_volume_emission(
+          kg, state, accum_emission, render_buffer, object_lightgroup(kg, sd->object));
+    }
+  }
+
+#  ifdef __DENOISING_FEATURES__
+  /* Write denoising features. */
+  if (write_denoising_features) {
+    film_write_denoising_features_volume(
+        kg, state, accum_albedo, result.indirect_scatter, render_buffer);
+  }
+#  endif /* __DENOISING_FEATURES__ */
+}
+
 /* Path tracing: sample point on light for equiangular sampling. */
 ccl_device_forceinline bool integrate_volume_equiangular_sample_light(
     KernelGlobals kg,
@@ -980,6 +1210,8 @@ ccl_device VolumeIntegrateEvent volume_integrate(KernelGlobals kg,
   /* Step through volume. */
   VOLUME_READ_LAMBDA(integrator_state_read_volume_stack(state, i))
   const float step_size = volume_stack_step_size(kg, volume_read_lambda_pass);
+  const bool use_tracking = (step_size != FLT_MAX) &&
+                            volume_stack_has_majorant(kg, volume_read_lambda_pass);
 
 #  if defined(__PATH_GUIDING__) && PATH_GUIDING_LEVEL >= 1
   /* The current path throughput which is used later to calculate per-segment throughput. */
@@ -993,16 +1225,22 @@ ccl_device VolumeIntegrateEvent volume_integrate(KernelGlobals kg,
 
   /* TODO: expensive to zero closures? */
   VolumeIntegrateResult result = {};
-  volume_integrate_heterogeneous(kg,
-                                 state,
-                                 ray,
-                                 &sd,
-                                 &rng_state,
-                                 render_buffer,
-                                 step_size,
-                                 direct_sample_method,
-                                 equiangular_coeffs,
-                                 result);
+  if (use_tracking) {
+    volume_integrate_heterogeneous_tracking(
+        kg, state, ray, &sd, &rng_state, render_buffer, result);
+  }
+  else {
+    volume_integrate_heterogeneous(kg,
+                                   state,
+                                   ray,
+                                   &sd,
+                                   &rng_state,
+                                   render_buffer,
+                                   step_size,
+                                   direct_sample_method,
+                                   equiangular_coeffs,
+                                   result);
+  }
 
   /* Perform path termination. The intersect_closest will have already marked this path
    * to be terminated. That will shading evaluating to leave out any scattering closures,
@@ -166,6 +166,71 @@ ccl_device float volume_stack_step_size(KernelGlobals kg, StackReadOp stack_read
   return step_size;
 }
 
+/* Check if all volumes in the stack have a majorant grid, so that delta tracking can be used
+ * instead of ray marching. */
+template<typename StackReadOp>
+ccl_device bool volume_stack_has_majorant(KernelGlobals kg, StackReadOp stack_read)
+{
+  if (!kernel_data.integrator.use_volume_delta_tracking) {
+    return false;
+  }
+
+  for (int i = 0;; i++) {
+    VolumeStack entry = stack_read(i);
+    if (entry.shader == SHADER_NONE) {
+      return i > 0;
+    }
+
+    if (object_volume_majorant_offset(kg, entry.object) < 0) {
+      return false;
+    }
+
+    /* Velocity moves the density away from the grid it was built from. */
+    if (kernel_data_fetch(object_flag, entry.object) & SD_OBJECT_HAS_VOLUME_MOTION) {
+      return false;
+    }
+  }
+}
+
+/* Sum of the majorants of all volumes in the stack at distance t along the ray, and the
+ * distance at which it next changes. */
+template<typename StackReadOp>
+ccl_device float volume_stack_majorant(KernelGlobals kg,
+                                       ccl_private const Ray *ccl_restrict ray,
+                                       const float t,
+                                       StackReadOp stack_read,
+                                       ccl_private float *t_next)
+{
+  float majorant = 0.0f;
+  *t_next = FLT_MAX;
+
+  /* Widen the emission step size for long segments like ray marching does, leaving half of the
+   * step limit for cell boundaries and collisions due to extinction. */
+  const float min_emission_step_size = 2.0f * (ray->tmax - ray->tmin) /
+                                       (float)kernel_data.integrator.volume_max_steps;
+
+  for (int i = 0;; i++) {
+    VolumeStack entry = stack_read(i);
+    if (entry.shader == SHADER_NONE) {
+      break;
+    }
+
+    float entry_t_next;
+    majorant += volume_majorant_grid(kg,
+                                     entry.object,
+                                     object_volume_majorant_offset(kg, entry.object),
+                                     ray->P,
+                                     ray->D,
+                                     ray->time,
+                                     t,
+                                     min_emission_step_size,
+                                     &entry_t_next);
+    *t_next = fminf(*t_next, entry_t_next);
+  }
+
+  return majorant;
+}
+
 typedef enum VolumeSampleMethod {
   VOLUME_SAMPLE_NONE = 0,
   VOLUME_SAMPLE_DISTANCE = (1 << 0),
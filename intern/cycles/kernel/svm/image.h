@@ -6,14 +6,19 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y, uint flags)
+ccl_device float4 svm_image_texture(
+    KernelGlobals kg, int id, float x, float y, float2 dx, float2 dy, uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
+#ifdef __KERNEL_CPU__
+  float4 r = kernel_tex_image_interp_filtered(kg, id, x, y, dx, dy);
+#else
   float4 r = kernel_tex_image_interp(kg, id, x, y);
+#endif
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -34,6 +39,19 @@ ccl_device_inline float3 texco_remap_square(float3 co)
   return (co - make_float3(0.5f, 0.5f, 0.5f)) * 2.0f;
 }
 
+ccl_device_inline float2 svm_image_project(float3 co, uint projection)
+{
+  if (projection == NODE_IMAGE_PROJ_SPHERE) {
+    return map_to_sphere(texco_remap_square(co));
+  }
+  else if (projection == NODE_IMAGE_PROJ_TUBE) {
+    return map_to_tube(texco_remap_square(co));
+  }
+  else {
+    return make_float2(co.x, co.y);
+  }
+}
+
 ccl_device_noinline int svm_node_tex_image(
     KernelGlobals kg, ccl_private ShaderData *sd, ccl_private float *stack, uint4 node, int offset)
 {
@@ -42,17 +60,16 @@ ccl_device_noinline int svm_node_tex_image(
   svm_unpack_node_uchar4(node.z, &co_offset, &out_offset, &alpha_offset, &flags);
 
   float3 co = stack_load_float3(stack, co_offset);
-  float2 tex_co;
-  if (node.w == NODE_IMAGE_PROJ_SPHERE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_sphere(co);
-  }
-  else if (node.w == NODE_IMAGE_PROJ_TUBE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_tube(co);
-  }
-  else {
-    tex_co = make_float2(co.x, co.y);
+  float2 tex_co = svm_image_project(co, node.w);
+
+  /* Texture coordinate derivatives, from copies of the coordinate shifted by the ray
+   * differentials. Used to choose the mip level of images in the texture cache. */
+  float2 tex_co_dx = zero_float2();
+  float2 tex_co_dy = zero_float2();
+  if (flags & NODE_IMAGE_DERIVATIVES) {
+    uint4 derivative_node = read_node(kg, &offset);
+    tex_co_dx = svm_image_project(stack_load_float3(stack, derivative_node.x), node.w) - tex_co;
+    tex_co_dy = svm_image_project(stack_load_float3(stack, derivative_node.y), node.w) - tex_co;
   }
 
   /* TODO(lukas): Consider moving tile information out of the SVM node.
@@ -98,7 +115,7 @@ ccl_device_noinline int svm_node_tex_image(
     id = -num_nodes;
   }
 
-  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, tex_co_dx, tex_co_dy, flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -192,15 +209,15 @@ ccl_device_noinline void svm_node_tex_image_box(KernelGlobals kg,
   /* Map so that no textures are flipped, rotation is somewhat arbitrary. */
   if (weight.x > 0.0f) {
     float2 uv = make_float2((signed_N.x < 0.0f) ? 1.0f - co.y : co.y, co.z);
-    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.y > 0.0f) {
     float2 uv = make_float2((signed_N.y > 0.0f) ? 1.0f - co.x : co.x, co.z);
-    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.z > 0.0f) {
     float2 uv = make_float2((signed_N.z > 0.0f) ? 1.0f - co.y : co.y, co.x);
-    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
 
   if (stack_valid(out_offset))
@@ -230,7 +247,7 @@ ccl_device_noinline void svm_node_tex_environment(KernelGlobals kg,
   else
     uv = direction_to_mirrorball(co);
 
-  float4 f = svm_image_texture(kg, id, uv.x, uv.y, flags);
+  float4 f = svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -216,11 +216,11 @@ CCL_NAMESPACE_BEGIN
 
 /* Main Interpreter Loop */
 template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
-ccl_device void svm_eval_nodes(KernelGlobals kg,
-                               ConstIntegratorGenericState state,
-                               ccl_private ShaderData *sd,
-                               ccl_global float *render_buffer,
-                               uint32_t path_flag)
+ccl_device void svm_eval_nodes_impl(KernelGlobals kg,
+                                    ConstIntegratorGenericState state,
+                                    ccl_private ShaderData *sd,
+                                    ccl_global float *render_buffer,
+                                    uint32_t path_flag)
 {
   float stack[SVM_STACK_SIZE];
   Spectrum closure_weight;
@@ -610,4 +610,36 @@ ccl_device void svm_eval_nodes(KernelGlobals kg,
   }
 }
 
+template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
+ccl_device_inline void svm_eval_nodes(KernelGlobals kg,
+                                      ConstIntegratorGenericState state,
+                                      ccl_private ShaderData *sd,
+                                      ccl_global float *render_buffer,
+                                      uint32_t path_flag)
+{
+#ifdef __KERNEL_CPU__
+  /* Select an interpreter specialized to the nodes used by the shader. Leaving out the nodes
+   * that are not used makes for a smaller main loop with fewer branches, which matters on the
+   * CPU where the whole program is compiled. On the GPU, the kernels are already specialized
+   * to the features of the scene. */
+  const uint shader_features = kernel_data_fetch(shaders, (sd->shader & SHADER_MASK))
+                                   .node_features;
+  if ((shader_features & KERNEL_FEATURE_NODE_MASK_SPECIALIZE) == 0) {
+    svm_eval_nodes_impl<node_feature_mask & ~KERNEL_FEATURE_NODE_MASK_SPECIALIZE, type>(
+        kg, state, sd, render_buffer, path_flag);
+    return;
+  }
+  /* Bump mapping is common enough to have its own specialization. */
+  constexpr uint bump_feature_mask = KERNEL_FEATURE_NODE_MASK_SPECIALIZE &
+                                     ~KERNEL_FEATURE_NODE_BUMP;
+  if ((shader_features & bump_feature_mask) == 0) {
+    svm_eval_nodes_impl<node_feature_mask & ~bump_feature_mask, type>(
+        kg, state, sd, render_buffer, path_flag);
+    return;
+  }
+#endif
+
+  svm_eval_nodes_impl<node_feature_mask, type>(kg, state, sd, render_buffer, path_flag);
+}
+
 CCL_NAMESPACE_END
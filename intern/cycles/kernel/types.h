@@ -45,6 +45,10 @@ CCL_NAMESPACE_BEGIN
 
 #define VOLUME_BOUNDS_MAX 1024
 
+/* Volume majorant grid: resolution, bounds minimum, inverse cell size and emission flag,
+ * followed by the cells. */
+#define VOLUME_MAJORANT_HEADER_SIZE 10
+
 #define SHADER_NONE (~0)
 #define OBJECT_NONE (~0)
 #define PRIM_NONE (~0)
@@ -66,6 +70,10 @@ CCL_NAMESPACE_BEGIN
 #  define INTEGRATOR_SHADOW_ISECT_SIZE INTEGRATOR_SHADOW_ISECT_SIZE_CPU
 #endif
 
+/* Maximum number of rays intersected together by the CPU packet traversal. Matches the widest
+ * packet Embree supports on AVX2. */
+#define RAY_PACKET_SIZE 8
+
 /* Kernel Features */
 
 /* Shader nodes. */
@@ -155,6 +163,12 @@ CCL_NAMESPACE_BEGIN
   (KERNEL_FEATURE_NODE_VORONOI_EXTRA | KERNEL_FEATURE_NODE_BUMP | KERNEL_FEATURE_NODE_BUMP_STATE)
 #define KERNEL_FEATURE_NODE_MASK_BUMP KERNEL_FEATURE_NODE_MASK_DISPLACEMENT
 
+/* Node features used by few shaders. On the CPU, shaders without these nodes are evaluated
+ * with SVM interpreters specialized to leave them out, see svm_eval_nodes(). */
+#define KERNEL_FEATURE_NODE_MASK_SPECIALIZE \
+  (KERNEL_FEATURE_NODE_VOLUME | KERNEL_FEATURE_NODE_BUMP | KERNEL_FEATURE_NODE_BUMP_STATE | \
+   KERNEL_FEATURE_NODE_VORONOI_EXTRA | KERNEL_FEATURE_NODE_RAYTRACE)
+
 /* Must be constexpr on the CPU to avoid compile errors because the state types
  * are different depending on the main, shadow or null path. For GPU we don't have
  * C++17 everywhere so need to check it. */
@@ -208,6 +222,8 @@ CCL_NAMESPACE_BEGIN
 #    define __PATH_GUIDING__
 #  endif
 #  define __VOLUME_RECORD_ALL__
+/* Intersection of multiple coherent rays at once, by the wavefront scheduler. */
+#  define __RAY_PACKETS__
 #endif /* !__KERNEL_GPU__ */
 
 /* MNEE caused "Compute function exceeds available temporary registers" in macOS < 13 due to a bug
@@ -529,6 +545,8 @@ typedef enum PassType {
   PASS_AOV_VALUE,
   PASS_ADAPTIVE_AUX_BUFFER,
   PASS_SAMPLE_COUNT,
+  /* Time spent rendering the pixel, for profiling. Only written on the CPU. */
+  PASS_RENDER_TIME,
   PASS_DIFFUSE_COLOR,
   PASS_GLOSSY_COLOR,
   PASS_TRANSMISSION_COLOR,
@@ -1750,7 +1768,9 @@ typedef struct KernelShader {
   float cryptomatte_id;
   int flags;
   int pass_id;
-  int pad2, pad3;
+  /* KERNEL_FEATURE_NODE_* used by the shader nodes, to select a specialized SVM evaluation. */
+  uint node_features;
+  int pad3;
 } KernelShader;
 static_assert_align(KernelShader, 16);
 
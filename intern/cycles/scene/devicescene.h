@@ -49,8 +49,12 @@ class DeviceScene {
   device_vector<DecomposedTransform> object_motion;
   device_vector<uint> object_flag;
   device_vector<float> object_volume_step;
+  device_vector<int> object_volume_majorant;
   device_vector<uint> object_prim_offset;
 
+  /* volume majorant grids */
+  device_vector<float> volume_majorant;
+
   /* cameras */
   device_vector<DecomposedTransform> camera_motion;
 
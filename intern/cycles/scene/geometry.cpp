@@ -64,6 +64,8 @@ Geometry::Geometry(const NodeType *node_type, const Type type)
   has_surface_bssrdf = false;
 
   bvh = NULL;
+  bvh_build_area = 0.0f;
+  bvh_num_refits = 0;
   attr_map_offset = 0;
   prim_offset = 0;
 }
@@ -505,8 +507,15 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
   if (device_update_flags & (DEVICE_MESH_DATA_NEEDS_REALLOC | DEVICE_CURVE_DATA_NEEDS_REALLOC |
                              DEVICE_POINT_DATA_NEEDS_REALLOC))
   {
-    delete scene->bvh;
-    scene->bvh = nullptr;
+    /* An Embree BVH built for refitting is updated per object, only the geometry that changed
+     * topology is rebuilt. Keep it as long as no geometry was added or removed. */
+    const bool keep_scene_bvh = scene->bvh != nullptr && scene->bvh->params.use_refit &&
+                                scene->bvh->params.bvh_layout == BVH_LAYOUT_EMBREE &&
+                                (update_flags & (GEOMETRY_ADDED | GEOMETRY_REMOVED)) == 0;
+    if (!keep_scene_bvh) {
+      delete scene->bvh;
+      scene->bvh = nullptr;
+    }
 
     dscene->bvh_nodes.tag_realloc();
     dscene->bvh_leaf_nodes.tag_realloc();
@@ -804,6 +813,7 @@ void GeometryManager::device_update(Device *device,
         progress.set_status("Updating Mesh", msg);
 
         mesh->subd_params->camera = dicing_camera;
+        mesh->subd_params->use_dicing_cache = scene->params.use_subd_dicing_cache;
         DiagSplit dsplit(*mesh->subd_params);
         mesh->tessellate(&dsplit);
 
@@ -1018,6 +1028,7 @@ void GeometryManager::device_update(Device *device,
   foreach (Geometry *geom, scene->geometry) {
     geom->clear_modified();
     geom->attributes.clear_modified();
+    geom->need_update_rebuild = false;
 
     if (geom->is_mesh()) {
       Mesh *mesh = static_cast<Mesh *>(geom);
@@ -101,6 +101,10 @@ class Geometry : public Node {
 
   /* BVH */
   BVH *bvh;
+  /* Surface area of the bounds when the BVH was last built, and number of times it was refit
+   * since, to detect when refitting degraded the BVH too much. */
+  float bvh_build_area;
+  int bvh_num_refits;
   size_t attr_map_offset;
   size_t prim_offset;
 
@@ -162,6 +166,10 @@ class Geometry : public Node {
   /* Test if the geometry should be treated as instanced. */
   bool is_instanced() const;
 
+  /* Test if refitting the BVH since it was last built degraded it enough that rebuilding is
+   * likely faster to render with. */
+  bool need_rebuild_bvh_for_quality() const;
+
   bool has_true_displacement() const;
   bool has_motion_blur() const;
   bool has_voxel_attributes() const;
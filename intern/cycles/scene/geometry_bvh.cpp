@@ -33,6 +33,23 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Refitting keeps the tree structure of the last build, which gets less efficient as primitives
+ * move away from where they were when it was built. As a cheap estimate of that, rebuild once the
+ * surface area of the bounds changed by more than this factor, or after this many refits. */
+static const float BVH_REFIT_MAX_AREA_RATIO = 1.5f;
+static const int BVH_REFIT_MAX_NUM = 16;
+
+bool Geometry::need_rebuild_bvh_for_quality() const
+{
+  if (bvh_num_refits >= BVH_REFIT_MAX_NUM) {
+    return true;
+  }
+
+  const float area = bounds.safe_area();
+  return area > bvh_build_area * BVH_REFIT_MAX_AREA_RATIO ||
+         area * BVH_REFIT_MAX_AREA_RATIO < bvh_build_area;
+}
+
 void Geometry::compute_bvh(Device *device,
                            DeviceScene *dscene,
                            SceneParams *params,
@@ -46,6 +63,25 @@ void Geometry::compute_bvh(Device *device,
 
   compute_bounds();
 
+  if (params->use_bvh_refit && is_modified()) {
+    /* The number of motion steps can not change when refitting. */
+    if (motion_steps_is_modified() || use_motion_blur_is_modified()) {
+      need_update_rebuild = true;
+    }
+    else if (!need_update_rebuild && need_rebuild_bvh_for_quality()) {
+      VLOG_DEBUG << "Rebuilding BVH of " << name << " after " << bvh_num_refits << " refits";
+      need_update_rebuild = true;
+    }
+
+    if (need_update_rebuild) {
+      bvh_build_area = bounds.safe_area();
+      bvh_num_refits = 0;
+    }
+    else {
+      bvh_num_refits++;
+    }
+  }
+
   const BVHLayout bvh_layout = BVHParams::best_bvh_layout(
       params->bvh_layout, device->get_bvh_layout_mask(dscene->data.kernel_features));
   if (need_build_bvh(bvh_layout)) {
@@ -84,6 +120,7 @@ void Geometry::compute_bvh(Device *device,
       BVHParams bparams;
       bparams.use_spatial_split = params->use_bvh_spatial_split;
       bparams.use_compact_structure = params->use_bvh_compact_structure;
+      bparams.use_refit = params->use_bvh_refit;
       bparams.bvh_layout = bvh_layout;
       bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                     params->use_bvh_unaligned_nodes;
@@ -99,7 +136,7 @@ void Geometry::compute_bvh(Device *device,
     }
   }
 
-  need_update_rebuild = false;
+  /* need_update_rebuild is cleared once the scene BVH was updated, which uses it too. */
   need_update_bvh_for_offset = false;
 }
 
@@ -116,6 +153,7 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.bvh_layout = BVHParams::best_bvh_layout(
       scene->params.bvh_layout, device->get_bvh_layout_mask(dscene->data.kernel_features));
   bparams.use_spatial_split = scene->params.use_bvh_spatial_split;
+  bparams.use_refit = scene->params.use_bvh_refit;
   bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                 scene->params.use_bvh_unaligned_nodes;
   bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
@@ -126,14 +164,25 @@ void GeometryManager::device_update_bvh(Device *device,
 
   VLOG_INFO << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
+  /* Embree refits geometry that only moved, and builds new BVHs for geometry that changed
+   * topology, as long as the same objects are in the scene. */
+  const bool can_refit_embree = bparams.bvh_layout == BVHLayout::BVH_LAYOUT_EMBREE &&
+                                bparams.use_refit && scene->bvh != nullptr &&
+                                scene->bvh->objects == scene->objects &&
+                                (update_flags & (GEOMETRY_ADDED | GEOMETRY_REMOVED |
+                                                 VISIBILITY_MODIFIED)) == 0;
+
   const bool can_refit = scene->bvh != nullptr &&
                          (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
-                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL);
+                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL || can_refit_embree);
 
   BVH *bvh = scene->bvh;
   if (!scene->bvh) {
     bvh = scene->bvh = BVH::create(bparams, scene->geometry, scene->objects, device);
   }
+  else if (!can_refit) {
+    bvh->replace_geometry(scene->geometry, scene->objects);
+  }
 
   device->build_bvh(bvh, progress, can_refit);
 
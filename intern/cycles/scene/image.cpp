@@ -5,9 +5,11 @@
 #include "scene/image.h"
 #include "device/device.h"
 #include "scene/colorspace.h"
+#include "scene/image_cache.h"
 #include "scene/image_oiio.h"
 #include "scene/image_vdb.h"
 #include "scene/scene.h"
+#include "scene/shader.h"
 #include "scene/stats.h"
 
 #include "util/foreach.h"
@@ -55,6 +57,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_fpn";
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
       return "nanovdb_fp16";
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return "texture_cache";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -312,6 +316,9 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
+
+  /* Texture cache lookups call into the host from the kernel. */
+  texture_cache_supported = (info.type == DEVICE_CPU);
 }
 
 ImageManager::~ImageManager()
@@ -326,6 +333,13 @@ void ImageManager::set_osl_texture_system(void *texture_system)
   osl_texture_system = texture_system;
 }
 
+bool ImageManager::use_texture_cache(const Scene *scene) const
+{
+  /* OSL has its own texture cache for image files. */
+  return texture_cache_supported && scene->params.use_texture_cache &&
+         !scene->shader_manager->use_osl();
+}
+
 bool ImageManager::set_animation_frame_update(int frame)
 {
   if (frame != animation_frame) {
@@ -474,6 +488,7 @@ size_t ImageManager::add_image_slot(ImageLoader *loader,
   img->builtin = builtin;
   img->users = 1;
   img->mem = NULL;
+  img->cache_image = NULL;
 
   images[slot] = img;
 
@@ -675,6 +690,27 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   return true;
 }
 
+TextureCacheImage *ImageManager::texture_cache_add_image(Scene *scene, Image *img)
+{
+  /* Only 2D image files are sampled through the cache, builtin images and volumes are always
+   * loaded fully. */
+  const ustring filepath = img->loader->osl_filepath();
+  if (filepath.empty() || img->loader->is_vdb_loader() || img->metadata.depth > 1 ||
+      !(img->metadata.channels > 0))
+  {
+    return NULL;
+  }
+
+  {
+    thread_scoped_lock cache_lock(texture_cache_mutex);
+    if (!texture_cache) {
+      texture_cache = make_unique<ImageCache>(scene->params.texture_cache_size);
+    }
+  }
+
+  return texture_cache->add_image(filepath.string(), img->params, img->metadata);
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, size_t slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -699,6 +735,37 @@ void ImageManager::device_load_image(Device *device, Scene *scene, size_t slot,
     delete img->mem;
     img->mem = NULL;
   }
+  if (img->cache_image) {
+    texture_cache->remove_image(img->cache_image);
+    img->cache_image = NULL;
+  }
+
+  /* Sample image files on demand through the texture cache, the device texture then only holds
+   * a pointer to the cached image. Fall back to loading the full image if this fails. */
+  if (use_texture_cache(scene)) {
+    img->cache_image = texture_cache_add_image(scene, img);
+  }
+
+  if (img->cache_image) {
+    type = IMAGE_DATA_TYPE_TEXTURE_CACHE;
+    img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(type), (int)slot);
+    img->mem = new device_texture(device,
+                                  img->mem_name.c_str(),
+                                  slot,
+                                  type,
+                                  img->params.interpolation,
+                                  img->params.extension);
+
+    thread_scoped_lock device_lock(device_mutex);
+    TextureCacheImage **data = (TextureCacheImage **)img->mem->alloc(sizeof(TextureCacheImage *),
+                                                                     1);
+    *data = img->cache_image;
+    img->mem->copy_to_device();
+
+    img->loader->cleanup();
+    img->need_load = false;
+    return;
+  }
 
   img->mem = new device_texture(
       device, img->mem_name.c_str(), slot, type, img->params.interpolation, img->params.extension);
@@ -834,6 +901,10 @@ void ImageManager::device_free_image(Device *, size_t slot)
     delete img->mem;
   }
 
+  if (img->cache_image) {
+    texture_cache->remove_image(img->cache_image);
+  }
+
   delete img->loader;
   delete img;
   images[slot] = NULL;
@@ -932,6 +1003,11 @@ void ImageManager::collect_statistics(RenderStats *stats)
     stats->image.textures.add_entry(
         NamedSizeEntry(image->loader->name(), image->mem->memory_size()));
   }
+
+  if (texture_cache) {
+    stats->image.textures.add_entry(
+        NamedSizeEntry("Texture Cache", texture_cache->memory_usage()));
+  }
 }
 
 void ImageManager::tag_update()
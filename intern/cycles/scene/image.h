@@ -19,6 +19,7 @@ CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceInfo;
+class ImageCache;
 class ImageHandle;
 class ImageKey;
 class ImageMetaData;
@@ -189,6 +190,9 @@ class ImageManager {
   void set_osl_texture_system(void *texture_system);
   bool set_animation_frame_update(int frame);
 
+  /* Sample image files on demand through the texture cache, instead of loading them fully. */
+  bool use_texture_cache(const Scene *scene) const;
+
   void collect_statistics(RenderStats *stats);
 
   void tag_update();
@@ -207,6 +211,7 @@ class ImageManager {
 
     string mem_name;
     device_texture *mem;
+    TextureCacheImage *cache_image;
 
     int users;
     thread_mutex mutex;
@@ -224,6 +229,10 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  bool texture_cache_supported;
+  thread_mutex texture_cache_mutex;
+  unique_ptr<ImageCache> texture_cache;
+
   size_t add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(size_t slot);
   void remove_image_user(size_t slot);
@@ -233,6 +242,8 @@ class ImageManager {
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
 
+  TextureCacheImage *texture_cache_add_image(Scene *scene, Image *img);
+
   void device_load_image(Device *device, Scene *scene, size_t slot, Progress *progress);
   void device_free_image(Device *device, size_t slot);
 
@@ -0,0 +1,222 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "scene/image_cache.h"
+#include "scene/colorspace.h"
+
+#include "util/log.h"
+#include "util/path.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Image sampled through the OpenImageIO texture system. Color space conversion and alpha
+ * association are done after filtering, so the cache stores the original file pixels. */
+class ImageCacheImage : public TextureCacheImage {
+ public:
+  ImageCacheImage(OIIO::TextureSystem *texture_system,
+                  OIIO::TextureSystem::TextureHandle *handle,
+                  const ImageParams &params,
+                  const ImageMetaData &metadata,
+                  const bool file_unassociated_alpha)
+      : texture_system(texture_system), handle(handle), processor(NULL)
+  {
+    switch (params.interpolation) {
+      case INTERPOLATION_CLOSEST:
+        options.interpmode = OIIO::TextureOpt::InterpClosest;
+        break;
+      case INTERPOLATION_CUBIC:
+        options.interpmode = OIIO::TextureOpt::InterpBicubic;
+        break;
+      case INTERPOLATION_SMART:
+        options.interpmode = OIIO::TextureOpt::InterpSmartBicubic;
+        break;
+      default:
+        options.interpmode = OIIO::TextureOpt::InterpBilinear;
+        break;
+    }
+
+    switch (params.extension) {
+      case EXTENSION_EXTEND:
+        options.swrap = options.twrap = OIIO::TextureOpt::WrapClamp;
+        break;
+      case EXTENSION_CLIP:
+        options.swrap = options.twrap = OIIO::TextureOpt::WrapBlack;
+        break;
+      case EXTENSION_MIRROR:
+        options.swrap = options.twrap = OIIO::TextureOpt::WrapMirror;
+        break;
+      default:
+        options.swrap = options.twrap = OIIO::TextureOpt::WrapPeriodic;
+        break;
+    }
+
+    /* Alpha for images without an alpha channel. */
+    options.fill = 1.0f;
+
+    /* Same alpha handling as image_associate_alpha() when loading the full image. */
+    ignore_alpha = (params.alpha_type == IMAGE_ALPHA_IGNORE);
+    associate_alpha = file_unassociated_alpha &&
+                      !(ColorSpaceManager::colorspace_is_data(params.colorspace) ||
+                        params.alpha_type == IMAGE_ALPHA_IGNORE ||
+                        params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED);
+
+    /* sRGB is converted in the kernel, see NODE_IMAGE_COMPRESS_AS_SRGB. */
+    if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+      processor = ColorSpaceManager::get_processor(metadata.colorspace);
+    }
+  }
+
+  float4 lookup(float x, float y, float2 dx, float2 dy) const override
+  {
+    /* Texture lookups may modify the options, so use a copy per lookup. */
+    OIIO::TextureOpt opt = options;
+    float result[4];
+
+    /* The texture system has the origin at the top of the image. */
+    if (!texture_system->texture(handle,
+                                 texture_system->get_perthread_info(),
+                                 opt,
+                                 x,
+                                 1.0f - y,
+                                 dx.x,
+                                 -dx.y,
+                                 dy.x,
+                                 -dy.y,
+                                 4,
+                                 result))
+    {
+      /* Clear the error so it does not accumulate. */
+      texture_system->geterror();
+      return make_float4(
+          TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+    }
+
+    if (ignore_alpha) {
+      result[3] = 1.0f;
+    }
+    else if (associate_alpha) {
+      result[0] *= result[3];
+      result[1] *= result[3];
+      result[2] *= result[3];
+    }
+
+    if (processor) {
+      ColorSpaceManager::to_scene_linear(processor, result, 4);
+    }
+
+    return make_float4(result[0], result[1], result[2], result[3]);
+  }
+
+  OIIO::TextureSystem *texture_system;
+  OIIO::TextureSystem::TextureHandle *handle;
+  OIIO::TextureOpt options;
+  ColorSpaceProcessor *processor;
+  bool ignore_alpha;
+  bool associate_alpha;
+  ustring filepath;
+};
+
+/* Prefer a tiled and mipmapped .tx file next to the image, as created by maketx, as long as it
+ * is not older than the image itself. */
+string image_cache_filepath(const string &filepath)
+{
+  const string filename = path_filename(filepath);
+  const size_t dot = filename.rfind('.');
+  if (dot == string::npos || string_iequals(filename.substr(dot), ".tx")) {
+    return filepath;
+  }
+
+  const string tx_filepath = path_join(path_dirname(filepath), filename.substr(0, dot) + ".tx");
+  if (path_exists(tx_filepath) &&
+      path_modified_time(tx_filepath) >= path_modified_time(filepath))
+  {
+    return tx_filepath;
+  }
+
+  return filepath;
+}
+
+}  // namespace
+
+ImageCache::ImageCache(const int size_mb)
+{
+  /* Private texture system, the OSL one is shared between renders and unlimited in size. */
+  texture_system = OIIO::TextureSystem::create(false);
+
+  /* Generate tiles and mip levels on the fly for images that are not tiled and mipmapped. */
+  texture_system->attribute("automip", 1);
+  texture_system->attribute("autotile", 64);
+  texture_system->attribute("gray_to_rgb", 1);
+  /* Keep file pixels unassociated, alpha is associated per image after filtering. */
+  texture_system->attribute("unassociatedalpha", 1);
+
+  texture_system->attribute("max_memory_MB", (float)size_mb);
+}
+
+ImageCache::~ImageCache()
+{
+  texture_system->invalidate_all(true);
+  OIIO::TextureSystem::destroy(texture_system);
+}
+
+TextureCacheImage *ImageCache::add_image(const string &filepath,
+                                         const ImageParams &params,
+                                         const ImageMetaData &metadata)
+{
+  const ustring cache_filepath(image_cache_filepath(filepath));
+
+  int exists = 0;
+  if (!texture_system->get_texture_info(
+          cache_filepath, 0, ustring("exists"), OIIO::TypeInt, &exists) ||
+      !exists)
+  {
+    texture_system->geterror();
+    return NULL;
+  }
+
+  OIIO::TextureSystem::TextureHandle *handle = texture_system->get_texture_handle(cache_filepath);
+  if (handle == NULL) {
+    texture_system->geterror();
+    return NULL;
+  }
+
+  int unassociated_alpha = 0;
+  if (!texture_system->get_texture_info(cache_filepath,
+                                        0,
+                                        ustring("oiio:UnassociatedAlpha"),
+                                        OIIO::TypeInt,
+                                        &unassociated_alpha))
+  {
+    texture_system->geterror();
+  }
+
+  VLOG_INFO << "Texture cache image " << cache_filepath.string();
+
+  ImageCacheImage *image = new ImageCacheImage(
+      texture_system, handle, params, metadata, unassociated_alpha != 0);
+  image->filepath = cache_filepath;
+  return image;
+}
+
+void ImageCache::remove_image(TextureCacheImage *image)
+{
+  if (image == NULL) {
+    return;
+  }
+
+  ImageCacheImage *cache_image = static_cast<ImageCacheImage *>(image);
+  texture_system->invalidate(cache_image->filepath);
+  delete cache_image;
+}
+
+size_t ImageCache::memory_usage() const
+{
+  long long memory_used = 0;
+  texture_system->getattribute("stat:cache_memory_used", OIIO::TypeInt64, &memory_used);
+  return (size_t)memory_used;
+}
+
+CCL_NAMESPACE_END
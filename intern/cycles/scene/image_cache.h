@@ -0,0 +1,47 @@
+/* SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#ifndef __IMAGE_CACHE_H__
+#define __IMAGE_CACHE_H__
+
+#include <OpenImageIO/texture.h>
+
+#include "scene/image.h"
+
+#include "util/string.h"
+#include "util/texture.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Image Cache
+ *
+ * On-demand texture cache for image files rendered on the CPU. Instead of loading images fully
+ * into memory, tiles are read as they are sampled and least recently used tiles are evicted to
+ * stay within the memory budget. Mip levels are read from tiled and mipmapped .tx files when
+ * available next to the image, or generated on the fly otherwise. */
+class ImageCache {
+ public:
+  /* Size is the maximum memory used for tiles, in megabytes. */
+  explicit ImageCache(const int size_mb);
+  ~ImageCache();
+
+  /* Create image sampled through the cache. Returns NULL if the file can not be read, in which
+   * case the image should be loaded fully instead. */
+  TextureCacheImage *add_image(const string &filepath,
+                               const ImageParams &params,
+                               const ImageMetaData &metadata);
+
+  /* Free image and any tiles of it in the cache. */
+  void remove_image(TextureCacheImage *image);
+
+  /* Memory currently used by tiles, in bytes. */
+  size_t memory_usage() const;
+
+ private:
+  OIIO::TextureSystem *texture_system;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __IMAGE_CACHE_H__ */
@@ -60,6 +60,7 @@ NODE_DEFINE(Integrator)
 
   SOCKET_INT(volume_max_steps, "Volume Max Steps", 1024);
   SOCKET_FLOAT(volume_step_rate, "Volume Step Rate", 1.0f);
+  SOCKET_BOOLEAN(use_volume_delta_tracking, "Use Volume Delta Tracking", false);
 
   static NodeEnum guiding_distribution_enum;
   guiding_distribution_enum.insert("PARALLAX_AWARE_VMM", GUIDING_TYPE_PARALLAX_AWARE_VMM);
@@ -222,6 +223,7 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
 
   kintegrator->volume_max_steps = volume_max_steps;
   kintegrator->volume_step_rate = volume_step_rate;
+  kintegrator->use_volume_delta_tracking = use_volume_delta_tracking;
 
   kintegrator->caustics_reflective = caustics_reflective;
   kintegrator->caustics_refractive = caustics_refractive;
@@ -357,6 +359,18 @@ void Integrator::tag_update(Scene *scene, uint32_t flag)
     scene->object_manager->tag_update(scene, ObjectManager::MOTION_BLUR_MODIFIED);
     scene->camera->tag_modified();
   }
+
+  if (use_volume_delta_tracking_is_modified()) {
+    scene->object_manager->need_flags_update = true;
+
+    /* Majorant grids are only built with delta tracking, which is done with the volume mesh. */
+    foreach (Geometry *geom, scene->geometry) {
+      if (geom->is_volume()) {
+        geom->tag_modified();
+      }
+    }
+    scene->geometry_manager->tag_update(scene, GeometryManager::GEOMETRY_MODIFIED);
+  }
 }
 
 uint Integrator::get_kernel_features() const
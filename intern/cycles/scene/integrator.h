@@ -44,6 +44,7 @@ class Integrator : public Node {
 
   NODE_SOCKET_API(int, volume_max_steps)
   NODE_SOCKET_API(float, volume_step_rate)
+  NODE_SOCKET_API(bool, use_volume_delta_tracking)
 
   NODE_SOCKET_API(bool, use_guiding);
   NODE_SOCKET_API(bool, deterministic_guiding);
@@ -805,6 +805,7 @@ void LightManager::device_update_tree(Device *,
   KernelIntegrator *kintegrator = &dscene->data.integrator;
 
   if (!kintegrator->use_light_tree) {
+    light_tree.reset();
     return;
   }
 
@@ -813,41 +814,55 @@ void LightManager::device_update_tree(Device *,
 
   /* TODO: For now, we'll start with a smaller number of max lights in a node.
    * More benchmarking is needed to determine what number works best. */
-  LightTree light_tree(scene, dscene, progress, 8);
-  LightTreeNode *root = light_tree.build(scene, dscene);
+  unique_ptr<LightTree> new_light_tree = make_unique<LightTree>(scene, dscene, progress, 8);
+
+  /* Refit the previous tree if the emitters are the same, as when only light strengths or
+   * transforms are animated. Building the tree is much more expensive. */
+  LightTreeNode *root;
+  if (light_tree && light_tree->can_refit(*new_light_tree)) {
+    VLOG_INFO << "Refit light tree.";
+    root = light_tree->refit(scene, dscene, *new_light_tree);
+  }
+  else {
+    light_tree = std::move(new_light_tree);
+    root = light_tree->build(scene, dscene);
+  }
+  new_light_tree.reset();
+
   if (progress.get_cancel()) {
+    light_tree.reset();
     return;
   }
 
   /* Create arguments for recursive tree flatten. */
   LightTreeFlatten flatten;
   flatten.scene = scene;
-  flatten.emitters = light_tree.get_emitters();
+  flatten.emitters = light_tree->get_emitters();
   flatten.object_lookup_offset = dscene->object_lookup_offset.data();
   /* We want to create separate arrays corresponding to triangles and lights,
    * which will be used to index back into the light tree for PDF calculations. */
   flatten.light_array = dscene->light_to_tree.alloc(kintegrator->num_lights);
   flatten.mesh_array = dscene->object_to_tree.alloc(scene->objects.size());
-  flatten.triangle_array = dscene->triangle_to_tree.alloc(light_tree.num_triangles);
+  flatten.triangle_array = dscene->triangle_to_tree.alloc(light_tree->num_triangles);
 
   /* Allocate emitters */
-  const size_t num_emitters = light_tree.num_emitters();
+  const size_t num_emitters = light_tree->num_emitters();
   KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(num_emitters);
 
   /* Update integrator state. */
   kintegrator->use_direct_light = num_emitters > 0;
 
   /* Test if light linking is used. */
-  const bool use_light_linking = root && (light_tree.light_link_receiver_used != 1);
+  const bool use_light_linking = root && (light_tree->light_link_receiver_used != 1);
   KernelLightLinkSet *klight_link_sets = dscene->data.light_link_sets;
   memset(klight_link_sets, 0, sizeof(dscene->data.light_link_sets));
 
-  VLOG_INFO << "Use light tree with " << num_emitters << " emitters and " << light_tree.num_nodes
+  VLOG_INFO << "Use light tree with " << num_emitters << " emitters and " << light_tree->num_nodes
             << " nodes.";
 
   if (!use_light_linking) {
     /* Regular light tree without linking. */
-    KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(light_tree.num_nodes);
+    KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(light_tree->num_nodes);
 
     if (root) {
       int next_node_index = 0;
@@ -863,7 +878,7 @@ void LightManager::device_update_tree(Device *,
     if (root) {
       /* Reserve enough size of all instance subtrees, then shrink back to
        * actual number of nodes used. */
-      light_link_nodes.resize(light_tree.num_nodes);
+      light_link_nodes.resize(light_tree->num_nodes);
       light_tree_emitters_copy_and_flatten(
           flatten, root, light_link_nodes.data(), kemitters, next_node_index);
       light_link_nodes.resize(next_node_index);
@@ -872,7 +887,7 @@ void LightManager::device_update_tree(Device *,
     /* Specialized light trees for linking. */
     for (uint64_t tree_index = 0; tree_index < LIGHT_LINK_SET_MAX; tree_index++) {
       const uint64_t tree_mask = uint64_t(1) << tree_index;
-      if (!(light_tree.light_link_receiver_used & tree_mask)) {
+      if (!(light_tree->light_link_receiver_used & tree_mask)) {
         continue;
       }
 
@@ -889,7 +904,7 @@ void LightManager::device_update_tree(Device *,
     memcpy(knodes, light_link_nodes.data(), light_link_nodes.size() * sizeof(*knodes));
 
     VLOG_INFO << "Specialized light tree for light linking, with "
-              << light_link_nodes.size() - light_tree.num_nodes << " additional nodes.";
+              << light_link_nodes.size() - light_tree->num_nodes << " additional nodes.";
   }
 
   /* Copy arrays to device. */
@@ -899,6 +914,12 @@ void LightManager::device_update_tree(Device *,
   dscene->object_to_tree.copy_to_device();
   dscene->object_lookup_offset.copy_to_device();
   dscene->triangle_to_tree.copy_to_device();
+
+  if (!scene->params.use_light_tree_refit) {
+    /* Free the emitters of the tree, which can take a lot of memory with many emissive
+     * triangles, if the tree will not be refit. */
+    light_tree.reset();
+  }
 }
 
 static void background_cdf(
@@ -16,12 +16,14 @@
 #include "util/ies.h"
 #include "util/thread.h"
 #include "util/types.h"
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceScene;
+class LightTree;
 class Progress;
 class Scene;
 class Shader;
@@ -166,6 +168,10 @@ class LightManager {
   bool last_background_enabled;
   int last_background_resolution;
 
+  /* Light tree of the last update, kept to refit it when the emitters do not change. Only kept
+   * with #SceneParams::use_light_tree_refit. */
+  unique_ptr<LightTree> light_tree;
+
   uint32_t update_flags;
 };
 
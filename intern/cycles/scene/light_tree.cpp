@@ -6,7 +6,9 @@
 #include "scene/mesh.h"
 #include "scene/object.h"
 
+#include "util/hash.h"
 #include "util/progress.h"
+#include "util/tbb.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -265,12 +267,24 @@ bool LightTree::triangle_usable_as_light(Mesh *mesh, int prim_id)
 
 void LightTree::add_mesh(Scene *scene, Mesh *mesh, int object_id)
 {
+  vector<int> prim_ids;
   size_t mesh_num_triangles = mesh->num_triangles();
   for (size_t i = 0; i < mesh_num_triangles; i++) {
     if (triangle_usable_as_light(mesh, i)) {
-      emitters_.emplace_back(scene, i, object_id);
+      prim_ids.push_back(i);
     }
   }
+
+  /* Computing the measure of every triangle is relatively expensive, do it in parallel. */
+  const size_t start = emitters_.size();
+  emitters_.resize(start + prim_ids.size());
+
+  parallel_for(blocked_range<size_t>(0, prim_ids.size(), MIN_EMITTERS_PER_THREAD),
+               [&](const blocked_range<size_t> &range) {
+                 for (size_t i = range.begin(); i != range.end(); i++) {
+                   emitters_[start + i] = LightTreeEmitter(scene, prim_ids[i], object_id);
+                 }
+               });
 }
 
 LightTree::LightTree(Scene *scene,
@@ -293,9 +307,11 @@ LightTree::LightTree(Scene *scene,
     if (light->is_enabled) {
       if (light->light_type == LIGHT_BACKGROUND || light->light_type == LIGHT_DISTANT) {
         distant_lights_.emplace_back(scene, ~device_light_index, scene_light_index);
+        emitters_hash_ = hash_uint3(emitters_hash_, scene_light_index, LIGHT_TREE_DISTANT);
       }
       else {
         local_lights_.emplace_back(scene, ~device_light_index, scene_light_index);
+        emitters_hash_ = hash_uint3(emitters_hash_, scene_light_index, LIGHT_TREE_LEAF);
       }
 
       device_light_index++;
@@ -319,7 +335,6 @@ LightTree::LightTree(Scene *scene,
     }
 
     mesh_lights_.emplace_back(object, object_id);
-    object_id++;
 
     /* Only count unique meshes. */
     Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
@@ -327,7 +342,21 @@ LightTree::LightTree(Scene *scene,
     if (map_it == offset_map_.end()) {
       offset_map_[mesh] = num_triangles;
       num_triangles += mesh->num_triangles();
+
+      emitters_hash_ = hash_uint3(
+          emitters_hash_, object_id, hash_uint2(uint(uintptr_t(mesh)), mesh->num_triangles()));
+      size_t mesh_num_triangles = mesh->num_triangles();
+      for (size_t i = 0; i < mesh_num_triangles; i++) {
+        if (triangle_usable_as_light(mesh, i)) {
+          emitters_hash_ = hash_uint2(emitters_hash_, i);
+        }
+      }
     }
+    else {
+      emitters_hash_ = hash_uint3(emitters_hash_, object_id, map_it->second);
+    }
+
+    object_id++;
   }
 }
 
@@ -377,28 +406,7 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
 
   /* Update measure. */
   parallel_for_each(mesh_lights_, [&](LightTreeEmitter &emitter) {
-    Object *object = scene->objects[emitter.object_id];
-    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
-
-    LightTreeNode *reference = std::get<0>(unique_mesh.find(mesh)->second);
-    emitter.measure = emitter.root->measure = reference->measure;
-
-    /* Transform measure. The measure is only directly transformable if the transformation has
-     * uniform scaling, otherwise recount all the triangles in the mesh with transformation. */
-    /* NOTE: in theory only energy needs recalculating: #bbox is available via `object->bounds`,
-     * transformation of #bcone is possible. However, the computation involves eigendecomposition
-     * and solving a cubic equation (https://doi.org/10.1016/j.nima.2009.11.075 section 3.4), then
-     * the angle is derived from the major axis of the resulted right elliptic cone's base, which
-     * can be an overestimation. */
-    if (!mesh->transform_applied && !emitter.measure.transform(object->get_tfm())) {
-      emitter.measure.reset();
-      size_t mesh_num_triangles = mesh->num_triangles();
-      for (size_t i = 0; i < mesh_num_triangles; i++) {
-        if (triangle_usable_as_light(mesh, i)) {
-          emitter.measure.add(LightTreeEmitter(scene, i, emitter.object_id, true).measure);
-        }
-      }
-    }
+    update_mesh_light_measure(scene, emitter, emitter.root->get_reference());
   });
 
   for (LightTreeEmitter &emitter : mesh_lights_) {
@@ -448,6 +456,127 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
   return root_.get();
 }
 
+void LightTree::update_mesh_light_measure(Scene *scene,
+                                          LightTreeEmitter &emitter,
+                                          const LightTreeNode *reference)
+{
+  Object *object = scene->objects[emitter.object_id];
+  Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+
+  emitter.measure = reference->measure;
+
+  /* Transform measure. The measure is only directly transformable if the transformation has
+   * uniform scaling, otherwise recount all the triangles in the mesh with transformation. */
+  /* NOTE: in theory only energy needs recalculating: #bbox is available via `object->bounds`,
+   * transformation of #bcone is possible. However, the computation involves eigendecomposition
+   * and solving a cubic equation (https://doi.org/10.1016/j.nima.2009.11.075 section 3.4), then
+   * the angle is derived from the major axis of the resulted right elliptic cone's base, which
+   * can be an overestimation. */
+  if (!mesh->transform_applied && !emitter.measure.transform(object->get_tfm())) {
+    emitter.measure.reset();
+    size_t mesh_num_triangles = mesh->num_triangles();
+    for (size_t i = 0; i < mesh_num_triangles; i++) {
+      if (triangle_usable_as_light(mesh, i)) {
+        emitter.measure.add(LightTreeEmitter(scene, i, emitter.object_id, true).measure);
+      }
+    }
+  }
+}
+
+bool LightTree::can_refit(const LightTree &other) const
+{
+  return root_ && emitters_hash_ == other.emitters_hash_ &&
+         max_lights_in_leaf_ == other.max_lights_in_leaf_;
+}
+
+LightTreeNode *LightTree::refit(Scene *scene, DeviceScene *dscene, const LightTree &other)
+{
+  light_link_receiver_used = other.light_link_receiver_used;
+
+  /* Update lights and triangles. The emitters keep their place in the tree, only the measure,
+   * centroid and light linking are recomputed. */
+  parallel_for(blocked_range<size_t>(0, emitters_.size(), MIN_EMITTERS_PER_THREAD),
+               [&](const blocked_range<size_t> &range) {
+                 for (size_t i = range.begin(); i != range.end(); i++) {
+                   LightTreeEmitter &emitter = emitters_[i];
+                   if (emitter.is_mesh()) {
+                     continue;
+                   }
+
+                   const LightTreeEmitter updated(scene, emitter.prim_id, emitter.object_id);
+                   emitter.centroid = updated.centroid;
+                   emitter.light_set_membership = updated.light_set_membership;
+                   emitter.measure = updated.measure;
+                 }
+               });
+
+  vector<LightTreeEmitter *> mesh_lights;
+  for (LightTreeEmitter &emitter : emitters_) {
+    if (emitter.is_mesh()) {
+      mesh_lights.push_back(&emitter);
+    }
+  }
+
+  /* Refit the subtree of each unique mesh light, before the measures of the mesh lights are
+   * computed from them. */
+  parallel_for_each(mesh_lights, [&](LightTreeEmitter *emitter) {
+    if (emitter->root->type != LIGHT_TREE_INSTANCE) {
+      refit_node(emitter->root.get());
+    }
+  });
+
+  parallel_for_each(mesh_lights, [&](LightTreeEmitter *emitter) {
+    update_mesh_light_measure(scene, *emitter, emitter->root->get_reference());
+  });
+
+  uint *object_offsets = dscene->object_lookup_offset.alloc(scene->objects.size());
+  for (LightTreeEmitter *emitter : mesh_lights) {
+    Object *object = scene->objects[emitter->object_id];
+    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+
+    emitter->root->measure = emitter->measure;
+    emitter->light_set_membership = object->get_light_set_membership();
+    object_offsets[emitter->object_id] = offset_map_[mesh];
+  }
+
+  /* Refit the top level tree. */
+  refit_node(root_.get());
+
+  /* Root nodes are never meant to be shared, see build(). */
+  root_->light_link.shareable = false;
+
+  return root_.get();
+}
+
+void LightTree::refit_node(LightTreeNode *node)
+{
+  node->measure = LightTreeMeasure::empty;
+  node->light_link = LightTreeLightLink();
+
+  if (node->is_leaf() || node->is_distant()) {
+    const LightTreeNode::Leaf &leaf = node->get_leaf();
+    const int start = leaf.first_emitter_index;
+    const int end = start + leaf.num_emitters;
+
+    /* Light set membership may have changed. */
+    sort_leaf(start, end, emitters_.data());
+
+    for (int i = start; i < end; i++) {
+      node->add(emitters_[i]);
+    }
+    return;
+  }
+
+  LightTreeNode *left_node = node->get_inner().children[left].get();
+  LightTreeNode *right_node = node->get_inner().children[right].get();
+
+  refit_node(left_node);
+  refit_node(right_node);
+
+  node->measure = left_node->measure + right_node->measure;
+  node->light_link = left_node->light_link + right_node->light_link;
+}
+
 void LightTree::recursive_build(const Child child,
                                 LightTreeNode *inner,
                                 const int start,
@@ -510,6 +639,35 @@ void LightTree::recursive_build(const Child child,
   }
 }
 
+using LightTreeBuckets = std::array<std::array<LightTreeBucket, LightTreeBucket::num_buckets>, 3>;
+
+static void fill_buckets(const LightTreeEmitter *emitters,
+                         const int start,
+                         const int end,
+                         const BoundBox &centroid_bbox,
+                         LightTreeBuckets &buckets)
+{
+  const float3 extent = centroid_bbox.size();
+
+  for (int i = start; i < end; i++) {
+    const LightTreeEmitter *emitter = emitters + i;
+
+    for (int dim = 0; dim < 3; dim++) {
+      /* Place emitter into the appropriate bucket, where the centroid box is split into equal
+       * partitions. All emitters go into the first bucket if the box is flat along `dim`. */
+      int bucket_idx = 0;
+      if (extent[dim] != 0.0f) {
+        const float inv_extent = 1 / extent[dim];
+        bucket_idx = LightTreeBucket::num_buckets *
+                     (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
+        bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
+      }
+
+      buckets[dim][bucket_idx].add(*emitter);
+    }
+  }
+}
+
 bool LightTree::should_split(LightTreeEmitter *emitters,
                              const int start,
                              int &middle,
@@ -530,9 +688,56 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
 
   middle = (start + end) / 2;
 
+  /* Large nodes near the top of the tree are where most of the build time goes, while the
+   * recursion only becomes parallel below them, so reduce over their emitters in parallel. */
+  const bool use_parallel = num_emitters > MIN_EMITTERS_PER_THREAD;
+  const blocked_range<int> range(start, end, MIN_EMITTERS_PER_THREAD);
+
   BoundBox centroid_bbox = BoundBox::empty;
-  for (int i = start; i < end; i++) {
-    centroid_bbox.grow((emitters + i)->centroid);
+  if (use_parallel) {
+    centroid_bbox = parallel_reduce(
+        range,
+        BoundBox(BoundBox::empty),
+        [emitters](const blocked_range<int> &r, BoundBox bbox) {
+          for (int i = r.begin(); i < r.end(); i++) {
+            bbox.grow(emitters[i].centroid);
+          }
+          return bbox;
+        },
+        [](BoundBox a, const BoundBox &b) {
+          a.grow(b);
+          return a;
+        });
+  }
+  else {
+    for (int i = start; i < end; i++) {
+      centroid_bbox.grow((emitters + i)->centroid);
+    }
+  }
+
+  /* Fill in buckets with emitters, for all dimensions at once. */
+  LightTreeBuckets all_buckets;
+  if (use_parallel) {
+    /* Merging cones is not associative, use a deterministic reduction so that the tree does not
+     * change between builds. */
+    all_buckets = parallel_deterministic_reduce(
+        range,
+        LightTreeBuckets(),
+        [&](const blocked_range<int> &r, LightTreeBuckets buckets) {
+          fill_buckets(emitters, r.begin(), r.end(), centroid_bbox, buckets);
+          return buckets;
+        },
+        [](LightTreeBuckets a, const LightTreeBuckets &b) {
+          for (int dim = 0; dim < 3; dim++) {
+            for (int i = 0; i < LightTreeBucket::num_buckets; i++) {
+              a[dim][i] = a[dim][i] + b[dim][i];
+            }
+          }
+          return a;
+        });
+  }
+  else {
+    fill_buckets(emitters, start, end, centroid_bbox, all_buckets);
   }
 
   const float3 extent = centroid_bbox.size();
@@ -550,19 +755,7 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
 
     const float inv_extent = 1 / (centroid_bbox.size()[dim]);
 
-    /* Fill in buckets with emitters. */
-    std::array<LightTreeBucket, LightTreeBucket::num_buckets> buckets;
-    for (int i = start; i < end; i++) {
-      const LightTreeEmitter *emitter = emitters + i;
-
-      /* Place emitter into the appropriate bucket, where the centroid box is split into equal
-       * partitions. */
-      int bucket_idx = LightTreeBucket::num_buckets *
-                       (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
-      bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
-
-      buckets[bucket_idx].add(*emitter);
-    }
+    const std::array<LightTreeBucket, LightTreeBucket::num_buckets> &buckets = all_buckets[dim];
 
     /* Precompute the left bucket measure cumulatively. */
     std::array<LightTreeBucket, LightTreeBucket::num_buckets - 1> left_buckets;
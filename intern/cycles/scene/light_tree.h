@@ -191,6 +191,7 @@ struct LightTreeEmitter {
 
   LightTreeMeasure measure;
 
+  LightTreeEmitter() = default; /* Uninitialized, for emitters which are assigned in parallel. */
   LightTreeEmitter(Object *object, int object_id); /* Mesh emitter. */
   LightTreeEmitter(Scene *scene, int prim_id, int object_id, bool with_transformation = false);
 
@@ -390,6 +391,9 @@ class LightTree {
 
   uint max_lights_in_leaf_;
 
+  /* Hash of which lights and triangles are emitters, independent of their measure. */
+  uint emitters_hash_ = 0;
+
  public:
   std::atomic<int> num_nodes = 0;
   size_t num_triangles = 0;
@@ -409,6 +413,15 @@ class LightTree {
   /* Returns a pointer to the root node. */
   LightTreeNode *build(Scene *scene, DeviceScene *dscene);
 
+  /* Check whether this tree can be refit to the scene for which the other tree was constructed,
+   * which is the case when both trees have the same emitters. */
+  bool can_refit(const LightTree &other) const;
+
+  /* Update the measures of all emitters and nodes for a changed scene, keeping the structure of
+   * the tree. Used when only light strengths or transforms changed, as it is much faster than
+   * building a new tree. Returns a pointer to the root node. */
+  LightTreeNode *refit(Scene *scene, DeviceScene *dscene, const LightTree &other);
+
   /* NOTE: Always use this function to create a new node so the number of nodes is in sync. */
   unique_ptr<LightTreeNode> create_node(const LightTreeMeasure &measure, const uint &bit_trial)
   {
@@ -453,6 +466,15 @@ class LightTree {
 
   /* Add all the emissive triangles of a mesh to the light tree. */
   void add_mesh(Scene *scene, Mesh *mesh, int object_id);
+
+  /* Compute the measure of a mesh light from the subtree of its mesh. */
+  void update_mesh_light_measure(Scene *scene,
+                                 LightTreeEmitter &emitter,
+                                 const LightTreeNode *reference);
+
+  /* Recompute the measure and light linking of a node and all nodes below it from the
+   * emitters. */
+  void refit_node(LightTreeNode *node);
 };
 
 CCL_NAMESPACE_END
@@ -199,6 +199,7 @@ Mesh::~Mesh()
 {
   delete patch_table;
   delete subd_params;
+  delete subd_dicing_cache;
 }
 
 void Mesh::resize_mesh(int numverts, int numtris)
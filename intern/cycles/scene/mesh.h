@@ -36,6 +36,7 @@ class AttributeRequest;
 struct SubdParams;
 class DiagSplit;
 struct PackedPatchTable;
+struct SubdDicingCache;
 
 /* Mesh */
 
@@ -160,6 +161,8 @@ class Mesh : public Geometry {
 
  private:
   PackedPatchTable *patch_table;
+  /* Diced subpatches of the previous tessellation, kept between syncs of the mesh. */
+  SubdDicingCache *subd_dicing_cache = nullptr;
   /* BVH */
   size_t vert_offset;
 
@@ -180,6 +183,7 @@ class Mesh : public Geometry {
   friend class BVHSpatialSplit;
   friend class DiagSplit;
   friend class EdgeDice;
+  friend class QuadDice;
   friend class GeometryManager;
   friend class ObjectManager;
 
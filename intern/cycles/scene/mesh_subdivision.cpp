@@ -13,6 +13,7 @@
 #include "util/algorithm.h"
 #include "util/foreach.h"
 #include "util/hash.h"
+#include "util/murmurhash.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -179,9 +180,12 @@ class OsdData {
   Far::TopologyRefiner *refiner;
   Far::PatchTable *patch_table;
   Far::PatchMap *patch_map;
+  int isolation_level;
 
  public:
-  OsdData() : mesh(NULL), refiner(NULL), patch_table(NULL), patch_map(NULL) {}
+  OsdData() : mesh(NULL), refiner(NULL), patch_table(NULL), patch_map(NULL), isolation_level(0)
+  {
+  }
 
   ~OsdData()
   {
@@ -207,6 +211,7 @@ class OsdData {
     /* adaptive refinement */
     int max_isolation = calculate_max_isolation();
     refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(max_isolation));
+    isolation_level = max_isolation;
 
     /* create patch table */
     Far::PatchTableFactory::Options patch_options;
@@ -394,6 +399,36 @@ struct OsdPatch : Patch {
 
 #endif
 
+template<typename T> static uint hash_array(const array<T> &data, const uint seed)
+{
+  return util_murmur_hash3(data.data(), data.size() * sizeof(T), seed);
+}
+
+/* Hash of everything the patches are evaluated from, to detect when diced grids of a previous
+ * tessellation can no longer be reused. */
+static uint subd_control_mesh_hash(Mesh *mesh, const int isolation_level)
+{
+  uint hash = hash_uint2(mesh->get_subdivision_type(), isolation_level);
+
+  hash = hash_array(mesh->get_verts(), hash);
+  hash = hash_array(mesh->get_subd_start_corner(), hash);
+  hash = hash_array(mesh->get_subd_num_corners(), hash);
+  hash = hash_array(mesh->get_subd_smooth(), hash);
+  hash = hash_array(mesh->get_subd_ptex_offset(), hash);
+  hash = hash_array(mesh->get_subd_face_corners(), hash);
+  hash = hash_array(mesh->get_subd_creases_edge(), hash);
+  hash = hash_array(mesh->get_subd_creases_weight(), hash);
+  hash = hash_array(mesh->get_subd_vert_creases(), hash);
+  hash = hash_array(mesh->get_subd_vert_creases_weight(), hash);
+
+  const Attribute *attr_vN = mesh->subd_attributes.find(ATTR_STD_VERTEX_NORMAL);
+  if (attr_vN) {
+    hash = util_murmur_hash3(attr_vN->data(), attr_vN->buffer.size(), hash);
+  }
+
+  return hash;
+}
+
 void Mesh::tessellate(DiagSplit *split)
 {
   /* reset the number of subdivision vertices, in case the Mesh was not cleared
@@ -423,6 +458,28 @@ void Mesh::tessellate(DiagSplit *split)
     }
   }
 
+  /* Keep the diced grids of the previous tessellation as long as the control mesh is the same. */
+  if (get_subd_params()->use_dicing_cache) {
+#ifdef WITH_OPENSUBDIV
+    const uint hash = subd_control_mesh_hash(this, osd_data.isolation_level);
+#else
+    const uint hash = subd_control_mesh_hash(this, 0);
+#endif
+
+    if (!subd_dicing_cache) {
+      subd_dicing_cache = new SubdDicingCache();
+    }
+    else if (subd_dicing_cache->mesh_hash != hash) {
+      subd_dicing_cache->grids.clear();
+    }
+
+    subd_dicing_cache->mesh_hash = hash;
+  }
+  else {
+    delete subd_dicing_cache;
+    subd_dicing_cache = nullptr;
+  }
+
   int num_faces = get_num_subd_faces();
 
   Attribute *attr_vN = subd_attributes.find(ATTR_STD_VERTEX_NORMAL);
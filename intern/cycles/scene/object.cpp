@@ -13,6 +13,7 @@
 #include "scene/particles.h"
 #include "scene/pointcloud.h"
 #include "scene/scene.h"
+#include "scene/shader.h"
 #include "scene/stats.h"
 #include "scene/volume.h"
 
@@ -765,6 +766,7 @@ void ObjectManager::device_update(Device *device,
     dscene->object_motion.tag_realloc();
     dscene->object_flag.tag_realloc();
     dscene->object_volume_step.tag_realloc();
+    dscene->object_volume_majorant.tag_realloc();
   }
 
   if (update_flags & HOLDOUT_MODIFIED) {
@@ -803,6 +805,7 @@ void ObjectManager::device_update(Device *device,
         dscene->object_motion.tag_modified();
         dscene->object_flag.tag_modified();
         dscene->object_volume_step.tag_modified();
+        dscene->object_volume_majorant.tag_modified();
       }
     }
   }
@@ -939,6 +942,11 @@ void ObjectManager::device_update_flags(
     }
   }
 
+  /* Volume majorant grids, once the volume step sizes are known. */
+  if (bounds_valid) {
+    device_update_volume_majorants(dscene, scene);
+  }
+
   /* Copy object flag. */
   dscene->object_flag.copy_to_device();
   dscene->object_volume_step.copy_to_device();
@@ -947,6 +955,87 @@ void ObjectManager::device_update_flags(
   dscene->object_volume_step.clear_modified();
 }
 
+void ObjectManager::device_update_volume_majorants(DeviceScene *dscene, Scene *scene)
+{
+  int *object_volume_majorant = dscene->object_volume_majorant.alloc(scene->objects.size());
+  uint *object_flag = dscene->object_flag.data();
+
+  /* Gather grids to pack, instances of the same volume share the grid. */
+  map<Geometry *, int> grid_offsets;
+  vector<Volume *> volumes;
+  size_t size = 0;
+
+  foreach (Object *object, scene->objects) {
+    object_volume_majorant[object->index] = -1;
+
+    if (!scene->integrator->get_use_volume_delta_tracking() || !object->geometry->is_volume() ||
+        object->geometry->transform_applied ||
+        (object_flag[object->index] & SD_OBJECT_HAS_VOLUME_MOTION))
+    {
+      continue;
+    }
+
+    Volume *volume = static_cast<Volume *>(object->geometry);
+    if (volume->majorant_grid.empty() || volume->get_used_shaders().empty()) {
+      continue;
+    }
+
+    Shader *shader = static_cast<Shader *>(volume->get_used_shaders()[0]);
+    if (!shader->has_volume_majorant) {
+      continue;
+    }
+
+    auto it = grid_offsets.find(volume);
+    if (it == grid_offsets.end()) {
+      it = grid_offsets.insert({volume, (int)size}).first;
+      volumes.push_back(volume);
+      size += VOLUME_MAJORANT_HEADER_SIZE + volume->majorant_grid.cells.size();
+    }
+
+    object_volume_majorant[object->index] = it->second;
+  }
+
+  if (size == 0) {
+    dscene->volume_majorant.free();
+    dscene->object_volume_majorant.copy_to_device();
+    dscene->object_volume_majorant.clear_modified();
+    return;
+  }
+
+  /* Pack header and cells, with the extinction scale of the shader baked in. */
+  float *volume_majorant = dscene->volume_majorant.alloc(size);
+
+  foreach (Volume *volume, volumes) {
+    const VolumeMajorantGrid &grid = volume->majorant_grid;
+    const Shader *shader = static_cast<const Shader *>(volume->get_used_shaders()[0]);
+    const float3 grid_size = grid.bounds.size();
+    float *data = volume_majorant + grid_offsets[volume];
+
+    data[0] = (float)grid.resolution.x;
+    data[1] = (float)grid.resolution.y;
+    data[2] = (float)grid.resolution.z;
+    data[3] = grid.bounds.min.x;
+    data[4] = grid.bounds.min.y;
+    data[5] = grid.bounds.min.z;
+    data[6] = safe_divide(data[0], grid_size.x);
+    data[7] = safe_divide(data[1], grid_size.y);
+    data[8] = safe_divide(data[2], grid_size.z);
+    data[9] = (shader->has_volume_emission) ? 1.0f : 0.0f;
+
+    data += VOLUME_MAJORANT_HEADER_SIZE;
+    for (size_t i = 0; i < grid.cells.size(); i++) {
+      data[i] = grid.cells[i] * shader->volume_majorant_scale;
+    }
+  }
+
+  VLOG_INFO << "Volume majorant grids: " << volumes.size() << ", "
+            << string_human_readable_size(size * sizeof(float));
+
+  dscene->volume_majorant.copy_to_device();
+  dscene->object_volume_majorant.copy_to_device();
+  dscene->object_volume_majorant.clear_modified();
+}
+
 void ObjectManager::device_update_geom_offsets(Device *, DeviceScene *dscene, Scene *scene)
 {
   if (dscene->objects.size() == 0) {
@@ -999,6 +1088,8 @@ void ObjectManager::device_free(Device *, DeviceScene *dscene, bool force_free)
   dscene->object_motion.free_if_need_realloc(force_free);
   dscene->object_flag.free_if_need_realloc(force_free);
   dscene->object_volume_step.free_if_need_realloc(force_free);
+  dscene->object_volume_majorant.free_if_need_realloc(force_free);
+  dscene->volume_majorant.free_if_need_realloc(force_free);
   dscene->object_prim_offset.free_if_need_realloc(force_free);
 }
 
@@ -1314,6 +1314,7 @@ void OSLCompiler::compile(OSLGlobals *og, Shader *shader)
 
     /* Estimate emission for MIS. */
     shader->estimate_emission();
+    shader->estimate_volume_majorant();
   }
 
   /* push state to array for lookup */
@@ -81,6 +81,7 @@ const NodeEnum *Pass::get_type_enum()
     pass_type_enum.insert("aov_value", PASS_AOV_VALUE);
     pass_type_enum.insert("adaptive_aux_buffer", PASS_ADAPTIVE_AUX_BUFFER);
     pass_type_enum.insert("sample_count", PASS_SAMPLE_COUNT);
+    pass_type_enum.insert("render_time", PASS_RENDER_TIME);
     pass_type_enum.insert("diffuse_color", PASS_DIFFUSE_COLOR);
     pass_type_enum.insert("glossy_color", PASS_GLOSSY_COLOR);
     pass_type_enum.insert("transmission_color", PASS_TRANSMISSION_COLOR);
@@ -320,6 +321,11 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bo
       pass_info.num_components = 1;
       pass_info.use_exposure = false;
       break;
+    case PASS_RENDER_TIME:
+      /* Filtered to get the average time per sample. */
+      pass_info.num_components = 1;
+      pass_info.use_exposure = false;
+      break;
 
     case PASS_AOV_COLOR:
       pass_info.num_components = 4;
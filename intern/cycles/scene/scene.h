@@ -67,11 +67,25 @@ class SceneParams {
   bool use_bvh_spatial_split;
   bool use_bvh_compact_structure;
   bool use_bvh_unaligned_nodes;
+  /* Refit the BVH of deforming geometry between updates instead of rebuilding it, for
+   * geometry that keeps the same topology. Used for persistent data across frames. */
+  bool use_bvh_refit;
+  /* Keep diced subdivision patches in the mesh, to reuse them when the mesh is tessellated again
+   * with the same control mesh and edge factors. */
+  bool use_subd_dicing_cache;
+  /* Keep the light tree after the update, to refit it when the emitters did not change. Only
+   * useful when the scene is updated again, as in interactive rendering or with persistent data. */
+  bool use_light_tree_refit;
   int num_bvh_time_steps;
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
 
+  /* Sample image files on demand through a tiled and mipmapped texture cache, instead of loading
+   * them fully into memory. Only supported on the CPU with SVM. Size is in megabytes. */
+  bool use_texture_cache;
+  int texture_cache_size;
+
   bool background;
 
   SceneParams()
@@ -82,10 +96,15 @@ class SceneParams {
     use_bvh_spatial_split = false;
     use_bvh_compact_structure = true;
     use_bvh_unaligned_nodes = true;
+    use_bvh_refit = false;
+    use_subd_dicing_cache = false;
+    use_light_tree_refit = false;
     num_bvh_time_steps = 0;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    use_texture_cache = false;
+    texture_cache_size = 4096;
     background = true;
   }
 
@@ -96,9 +115,14 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_compact_structure == params.use_bvh_compact_structure &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
+             use_bvh_refit == params.use_bvh_refit &&
+             use_subd_dicing_cache == params.use_subd_dicing_cache &&
+             use_light_tree_refit == params.use_light_tree_refit &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             use_texture_cache == params.use_texture_cache &&
+             texture_cache_size == params.texture_cache_size);
   }
 
   int curve_subdivisions()
@@ -111,6 +111,10 @@ Shader::Shader() : Node(get_node_type())
   emission_sampling = EMISSION_SAMPLING_NONE;
   emission_is_constant = true;
 
+  volume_majorant_scale = 0.0f;
+  has_volume_majorant = false;
+  has_volume_emission = false;
+
   displacement_method = DISPLACE_BUMP;
 
   id = -1;
@@ -283,6 +287,107 @@ void Shader::estimate_emission()
   }
 }
 
+static bool output_estimate_volume_majorant(ShaderOutput *output,
+                                            float &scale,
+                                            bool &has_emission)
+{
+  /* Only supports a few nodes for now, not arbitrary shader graphs. Returns false if the
+   * extinction can not be bounded by a multiple of the density grid. */
+  ShaderNode *node = (output) ? output->parent : nullptr;
+
+  scale = 0.0f;
+
+  if (node == nullptr) {
+    return true;
+  }
+  else if (node->type == PrincipledVolumeNode::get_node_type()) {
+    PrincipledVolumeNode *volume_node = static_cast<PrincipledVolumeNode *>(node);
+    ShaderInput *color_in = node->input("Color");
+    ShaderInput *density_in = node->input("Density");
+    ShaderInput *emission_in = node->input("Emission Strength");
+    ShaderInput *blackbody_in = node->input("Blackbody Intensity");
+
+    if (emission_in->link || volume_node->get_emission_strength() > 0.0f || blackbody_in->link ||
+        volume_node->get_blackbody_intensity() > 0.0f)
+    {
+      has_emission = true;
+    }
+
+    /* Extinction is the density times the scattering color plus absorption, which is at most
+     * the density times the largest of one and the color. */
+    if (color_in->link || density_in->link || !volume_node->get_color_attribute().empty() ||
+        volume_node->get_density_attribute() != ustring("density"))
+    {
+      return false;
+    }
+
+    const float3 color = node->get_float3(color_in->socket_type);
+    scale = max(node->get_float(density_in->socket_type), 0.0f) *
+            max(reduce_max(color), 1.0f);
+    return true;
+  }
+  else if (node->type == EmissionNode::get_node_type()) {
+    /* Emission without extinction. */
+    has_emission = true;
+    return true;
+  }
+  else if (node->type == AddClosureNode::get_node_type()) {
+    /* Add Closure. */
+    ShaderInput *closure1_in = node->input("Closure1");
+    ShaderInput *closure2_in = node->input("Closure2");
+
+    float scale1, scale2;
+    if (!output_estimate_volume_majorant(closure1_in->link, scale1, has_emission) ||
+        !output_estimate_volume_majorant(closure2_in->link, scale2, has_emission))
+    {
+      return false;
+    }
+
+    scale = scale1 + scale2;
+    return true;
+  }
+  else if (node->type == MixClosureNode::get_node_type()) {
+    /* Mix Closure. */
+    ShaderInput *fac_in = node->input("Fac");
+    ShaderInput *closure1_in = node->input("Closure1");
+    ShaderInput *closure2_in = node->input("Closure2");
+
+    float scale1, scale2;
+    if (!output_estimate_volume_majorant(closure1_in->link, scale1, has_emission) ||
+        !output_estimate_volume_majorant(closure2_in->link, scale2, has_emission))
+    {
+      return false;
+    }
+
+    if (fac_in->link) {
+      scale = max(scale1, scale2);
+    }
+    else {
+      const float fac = saturatef(node->get_float(fac_in->socket_type));
+      scale = (1.0f - fac) * scale1 + fac * scale2;
+    }
+    return true;
+  }
+
+  /* Other nodes, including homogeneous volumes which do not depend on the density grid. */
+  return false;
+}
+
+void Shader::estimate_volume_majorant()
+{
+  volume_majorant_scale = 0.0f;
+  has_volume_emission = false;
+  has_volume_majorant = false;
+
+  if (!has_volume) {
+    return;
+  }
+
+  ShaderInput *volume_in = graph->output()->input("Volume");
+  has_volume_majorant = output_estimate_volume_majorant(
+      volume_in->link, volume_majorant_scale, has_volume_emission);
+}
+
 void Shader::set_graph(ShaderGraph *graph_)
 {
   /* do this here already so that we can detect if mesh or object attributes
@@ -406,6 +511,11 @@ void Shader::tag_update(Scene *scene)
     scene->object_manager->need_flags_update = true;
     prev_volume_step_rate = volume_step_rate;
   }
+
+  /* Volume majorants are scaled by the shader, see estimate_volume_majorant(). */
+  if (has_volume && scene->integrator->get_use_volume_delta_tracking()) {
+    scene->object_manager->need_flags_update = true;
+  }
 }
 
 void Shader::tag_used(Scene *scene)
@@ -606,6 +716,20 @@ void ShaderManager::device_update_common(Device * /*device*/,
     /* regular shader */
     kshader->flags = flag;
     kshader->pass_id = shader->get_pass_id();
+    kshader->node_features = get_shader_kernel_features(shader) &
+                             KERNEL_FEATURE_NODE_MASK_SPECIALIZE;
+    /* The bump program is compiled even if the displacement got constant folded away. */
+    if (shader->has_bump) {
+      kshader->node_features |= KERNEL_FEATURE_NODE_BUMP;
+      if (shader->get_displacement_method() == DISPLACE_BOTH) {
+        kshader->node_features |= KERNEL_FEATURE_NODE_BUMP_STATE;
+      }
+    }
+    /* Volume attributes are read by attribute nodes, so a volume needs volume nodes even
+     * without any volume closure node. */
+    if (shader->has_volume) {
+      kshader->node_features |= KERNEL_FEATURE_NODE_VOLUME;
+    }
     kshader->constant_emission[0] = shader->emission_estimate.x;
     kshader->constant_emission[1] = shader->emission_estimate.y;
     kshader->constant_emission[2] = shader->emission_estimate.z;
@@ -759,11 +883,30 @@ uint ShaderManager::get_graph_kernel_features(ShaderGraph *graph)
     if (node->has_surface_transparent()) {
       kernel_features |= KERNEL_FEATURE_TRANSPARENT;
     }
+    /* Nodes copied for bump or texture coordinate derivatives compile to their bump variants,
+     * also when the node type does not report bump features itself. */
+    if (node->bump != SHADER_BUMP_NONE) {
+      kernel_features |= KERNEL_FEATURE_NODE_BUMP;
+    }
   }
 
   return kernel_features;
 }
 
+uint ShaderManager::get_shader_kernel_features(Shader *shader)
+{
+  /* Gather requested features from all the nodes from the graph nodes. */
+  uint kernel_features = get_graph_kernel_features(shader->graph);
+  ShaderNode *output_node = shader->graph->output();
+  if (output_node->input("Displacement")->link != NULL) {
+    kernel_features |= KERNEL_FEATURE_NODE_BUMP;
+    if (shader->get_displacement_method() == DISPLACE_BOTH) {
+      kernel_features |= KERNEL_FEATURE_NODE_BUMP_STATE;
+    }
+  }
+  return kernel_features;
+}
+
 uint ShaderManager::get_kernel_features(Scene *scene)
 {
   uint kernel_features = KERNEL_FEATURE_NODE_BSDF | KERNEL_FEATURE_NODE_EMISSION;
@@ -773,15 +916,7 @@ uint ShaderManager::get_kernel_features(Scene *scene)
       continue;
     }
 
-    /* Gather requested features from all the nodes from the graph nodes. */
-    kernel_features |= get_graph_kernel_features(shader->graph);
-    ShaderNode *output_node = shader->graph->output();
-    if (output_node->input("Displacement")->link != NULL) {
-      kernel_features |= KERNEL_FEATURE_NODE_BUMP;
-      if (shader->get_displacement_method() == DISPLACE_BOTH) {
-        kernel_features |= KERNEL_FEATURE_NODE_BUMP_STATE;
-      }
-    }
+    kernel_features |= get_shader_kernel_features(shader);
     /* On top of volume nodes, also check if we need volume sampling because
      * e.g. an Emission node would slip through the KERNEL_FEATURE_NODE_VOLUME check */
     if (shader->has_volume_connected) {
@@ -119,6 +119,12 @@ class Shader : public Node {
   EmissionSampling emission_sampling;
   bool emission_is_constant;
 
+  /* Upper bound of the volume extinction per unit of the density grid, valid only when
+   * has_volume_majorant is set. */
+  float volume_majorant_scale;
+  bool has_volume_majorant;
+  bool has_volume_emission;
+
   /* requested mesh attributes */
   AttributeRequestSet attributes;
 
@@ -143,6 +149,11 @@ class Shader : public Node {
    * entirely for a light. */
   void estimate_emission();
 
+  /* Estimate an upper bound of the volume extinction of this shader, relative to the density
+   * grid of the volume. Like the emission estimate this works only for simple shader graphs,
+   * other volume shaders are rendered without delta tracking. */
+  void estimate_volume_majorant();
+
   void set_graph(ShaderGraph *graph);
   void tag_update(Scene *scene);
   void tag_used(Scene *scene);
@@ -243,6 +254,7 @@ class ShaderManager {
   size_t ensure_bsdf_table_impl(DeviceScene *dscene, Scene *scene, const float *table, size_t n);
 
   uint get_graph_kernel_features(ShaderGraph *graph);
+  uint get_shader_kernel_features(Shader *shader);
 
   thread_spin_lock attribute_lock_;
 
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: Apache-2.0 */
 
 #include "scene/stats.h"
+#include "scene/light.h"
 #include "scene/object.h"
 #include "util/algorithm.h"
 #include "util/foreach.h"
@@ -39,6 +40,36 @@ bool namedSampleCountPairComparator(const NamedSampleCountPair &a, const NamedSa
   return a.samples > b.samples;
 }
 
+string json_string(const string &str)
+{
+  string result = "\"";
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          result += string_printf("\\u%04x", c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result + "\"";
+}
+
 }  // namespace
 
 NamedSizeEntry::NamedSizeEntry() : name(""), size(0) {}
@@ -146,6 +177,26 @@ string NamedNestedSampleStats::full_report(int indent_level, uint64_t total_samp
   return result;
 }
 
+string NamedNestedSampleStats::json_report()
+{
+  update_sum();
+
+  string result = string_printf("{\"name\": %s, \"time\": %.3f, \"self_time\": %.3f",
+                                json_string(name).c_str(),
+                                sum_samples * 0.001,
+                                self_samples * 0.001);
+  if (!entries.empty()) {
+    sort(entries.begin(), entries.end(), namedTimeSampleEntryComparator);
+    result += ", \"entries\": [";
+    for (size_t i = 0; i < entries.size(); i++) {
+      result += (i == 0) ? "" : ", ";
+      result += entries[i].json_report();
+    }
+    result += "]";
+  }
+  return result + "}";
+}
+
 /* Named sample count pairs. */
 
 NamedSampleCountPair::NamedSampleCountPair(const ustring &name, uint64_t samples, uint64_t hits)
@@ -198,6 +249,43 @@ string NamedSampleCountStats::full_report(int indent_level)
   return result;
 }
 
+string NamedSampleCountStats::json_report()
+{
+  vector<NamedSampleCountPair> sorted_entries;
+  sorted_entries.reserve(entries.size());
+
+  uint64_t total_hits = 0, total_samples = 0;
+  foreach (entry_map::const_reference entry, entries) {
+    const NamedSampleCountPair &pair = entry.second;
+
+    total_hits += pair.hits;
+    total_samples += pair.samples;
+
+    sorted_entries.push_back(pair);
+  }
+  const double avg_samples_per_hit = ((double)total_samples) / total_hits;
+
+  sort(sorted_entries.begin(), sorted_entries.end(), namedSampleCountPairComparator);
+
+  string result = "[";
+  for (size_t i = 0; i < sorted_entries.size(); i++) {
+    const NamedSampleCountPair &entry = sorted_entries[i];
+    /* Avoid writing non-finite numbers, which are not valid JSON. */
+    const double relative = (entry.hits) ?
+                                ((double)entry.samples) / (entry.hits * avg_samples_per_hit) :
+                                0.0;
+
+    result += (i == 0) ? "" : ", ";
+    result += string_printf(
+        "{\"name\": %s, \"time\": %.3f, \"hits\": %llu, \"relative_cost\": %.3f}",
+        json_string(entry.name.string()).c_str(),
+        entry.samples * 0.001,
+        (unsigned long long)entry.hits,
+        relative);
+  }
+  return result + "]";
+}
+
 /* Mesh statistics. */
 
 MeshStats::MeshStats() {}
@@ -280,6 +368,20 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
       objects.add(object->name, samples, hits);
     }
   }
+
+  /* Same order as the lights in the device array, see LightManager::device_update_lights. */
+  lights.entries.clear();
+  int light_index = 0;
+  foreach (Light *light, scene->lights) {
+    if (light->get_is_portal() || !light->get_is_enabled()) {
+      continue;
+    }
+    uint64_t samples, hits;
+    if (prof.get_light(light_index, samples, hits)) {
+      lights.add(light->name, samples, hits);
+    }
+    light_index++;
+  }
 }
 
 string RenderStats::full_report()
@@ -291,6 +393,7 @@ string RenderStats::full_report()
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
     result += "Object statistics:\n" + objects.full_report(1);
+    result += "Light statistics:\n" + lights.full_report(1);
   }
   else {
     result += "Profiling information not available (only works with CPU rendering)";
@@ -298,6 +401,20 @@ string RenderStats::full_report()
   return result;
 }
 
+string RenderStats::profiling_json_report()
+{
+  if (!has_profiling) {
+    return "{}";
+  }
+
+  string result = "{\n";
+  result += "  \"kernel\": " + kernel.json_report() + ",\n";
+  result += "  \"shaders\": " + shaders.json_report() + ",\n";
+  result += "  \"objects\": " + objects.json_report() + ",\n";
+  result += "  \"lights\": " + lights.json_report() + "\n";
+  return result + "}\n";
+}
+
 NamedTimeStats::NamedTimeStats() : total_time(0.0) {}
 
 string UpdateTimeStats::full_report(int indent_level)
@@ -102,6 +102,9 @@ class NamedNestedSampleStats {
 
   string full_report(int indent_level = 0, uint64_t total_samples = 0);
 
+  /* Generate report as JSON object, with times in seconds. */
+  string json_report();
+
   string name;
 
   /* self_samples contains only the samples that this specific event got,
@@ -129,6 +132,10 @@ class NamedSampleCountStats {
   NamedSampleCountStats();
 
   string full_report(int indent_level = 0);
+
+  /* Generate report as JSON array, sorted by time in descending order. */
+  string json_report();
+
   void add(const ustring &name, uint64_t samples, uint64_t hits);
 
   typedef unordered_map<ustring, NamedSampleCountPair> entry_map;
@@ -169,6 +176,9 @@ class RenderStats {
   /* Return full report as string. */
   string full_report();
 
+  /* Return kernel sampling information as JSON, for external tools. */
+  string profiling_json_report();
+
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
@@ -179,6 +189,7 @@ class RenderStats {
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
+  NamedSampleCountStats lights;
 };
 
 class UpdateTimeStats {
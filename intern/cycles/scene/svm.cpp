@@ -946,6 +946,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
 
   /* Estimate emission for MIS. */
   shader->estimate_emission();
+  shader->estimate_volume_majorant();
 }
 
 /* Compiler summary implementation. */
@@ -5,6 +5,7 @@
 #include "scene/volume.h"
 #include "scene/attribute.h"
 #include "scene/image_vdb.h"
+#include "scene/integrator.h"
 #include "scene/scene.h"
 
 #ifdef WITH_OPENVDB
@@ -12,12 +13,14 @@
 #  include <openvdb/tools/GridTransformer.h>
 #  include <openvdb/tools/Morphology.h>
 #  include <openvdb/tools/Statistics.h>
+#  include <openvdb/tree/LeafManager.h>
 #endif
 
 #include "util/hash.h"
 #include "util/log.h"
 #include "util/openvdb.h"
 #include "util/progress.h"
+#include "util/tbb.h"
 #include "util/types.h"
 
 CCL_NAMESPACE_BEGIN
@@ -44,6 +47,7 @@ Volume::Volume() : Mesh(get_node_type(), Geometry::VOLUME)
 void Volume::clear(bool preserve_shaders)
 {
   Mesh::clear(preserve_shaders, true);
+  majorant_grid.clear();
 }
 
 struct QuadData {
@@ -629,6 +633,121 @@ static void merge_scalar_grids_for_velocity(const Scene *scene, Volume *volume)
   ImageParams params;
   attr->data_voxel() = scene->image_manager->add_image(loader, params);
 }
+
+/* Number of voxels along each axis of a majorant grid cell, and maximum resolution. */
+static const int VOLUME_MAJORANT_CELL_VOXELS = 8;
+static const int VOLUME_MAJORANT_MAX_RESOLUTION = 64;
+
+/* Transform voxel bounds to object space, voxel centers are at integer coordinates. */
+static BoundBox volume_majorant_object_bbox(const openvdb::math::Transform &transform,
+                                            const openvdb::CoordBBox &bbox)
+{
+  BoundBox object_bbox = BoundBox::empty;
+  for (int i = 0; i < 8; i++) {
+    const openvdb::Vec3d corner((i & 1) ? bbox.max().x() + 0.5 : bbox.min().x() - 0.5,
+                                (i & 2) ? bbox.max().y() + 0.5 : bbox.min().y() - 0.5,
+                                (i & 4) ? bbox.max().z() + 0.5 : bbox.min().z() - 0.5);
+    const openvdb::Vec3d P = transform.indexToWorld(corner);
+    object_bbox.grow(make_float3((float)P.x(), (float)P.y(), (float)P.z()));
+  }
+  return object_bbox;
+}
+
+static void volume_majorant_grid_add(VolumeMajorantGrid &majorant,
+                                     const float3 inv_cell_size,
+                                     const BoundBox &object_bbox,
+                                     const float value)
+{
+  const float3 cell_min = floor((object_bbox.min - majorant.bounds.min) * inv_cell_size);
+  const float3 cell_max = floor((object_bbox.max - majorant.bounds.min) * inv_cell_size);
+  const int3 &resolution = majorant.resolution;
+
+  const int x_min = clamp((int)cell_min.x, 0, resolution.x - 1);
+  const int y_min = clamp((int)cell_min.y, 0, resolution.y - 1);
+  const int z_min = clamp((int)cell_min.z, 0, resolution.z - 1);
+  const int x_max = clamp((int)cell_max.x, 0, resolution.x - 1);
+  const int y_max = clamp((int)cell_max.y, 0, resolution.y - 1);
+  const int z_max = clamp((int)cell_max.z, 0, resolution.z - 1);
+
+  for (int z = z_min; z <= z_max; z++) {
+    for (int y = y_min; y <= y_max; y++) {
+      for (int x = x_min; x <= x_max; x++) {
+        float &cell = majorant.cells[x + resolution.x * (y + resolution.y * z)];
+        cell = max(cell, value);
+      }
+    }
+  }
+}
+
+/* Build a grid with the maximum density in each cell, within the bounds of the volume mesh.
+ * Voxels are dilated by the interpolation filter radius, so that the grid bounds any value
+ * interpolated from them. Tiles and leaf nodes are handled as a whole, which is conservative. */
+static void volume_majorant_grid_build(VolumeMajorantGrid &majorant,
+                                       openvdb::FloatGrid::ConstPtr grid,
+                                       const BoundBox &bounds,
+                                       const int filter_radius)
+{
+  const openvdb::math::Transform &transform = grid->transform();
+  const openvdb::Vec3d voxel_size = transform.voxelSize();
+  const float3 cell_size_target = VOLUME_MAJORANT_CELL_VOXELS * make_float3((float)voxel_size.x(),
+                                                                            (float)voxel_size.y(),
+                                                                            (float)voxel_size.z());
+  const float3 size = bounds.size();
+  const float3 resolution = clamp(ceil(safe_divide(size, cell_size_target)),
+                                  make_float3(1.0f),
+                                  make_float3((float)VOLUME_MAJORANT_MAX_RESOLUTION));
+
+  majorant.bounds = bounds;
+  majorant.resolution = make_int3((int)resolution.x, (int)resolution.y, (int)resolution.z);
+  majorant.cells.clear();
+  majorant.cells.resize(
+      size_t(majorant.resolution.x) * majorant.resolution.y * majorant.resolution.z, 0.0f);
+
+  const float3 inv_cell_size = safe_divide(resolution, size);
+
+  /* Leaf nodes. Find the maximum value and bounds of each leaf in parallel, the grid cells they
+   * overlap are few and cheap to update afterwards. */
+  const openvdb::tree::LeafManager<const openvdb::FloatTree> leaf_manager(grid->tree());
+  const size_t num_leaves = leaf_manager.leafCount();
+  vector<float> leaf_values(num_leaves);
+  vector<BoundBox> leaf_bboxes(num_leaves);
+
+  parallel_for(size_t(0), num_leaves, [&](const size_t i) {
+    const openvdb::FloatTree::LeafNodeType &leaf = leaf_manager.leaf(i);
+    float value = 0.0f;
+    for (openvdb::FloatTree::LeafNodeType::ValueOnCIter iter = leaf.cbeginValueOn(); iter; ++iter)
+    {
+      value = max(value, *iter);
+    }
+
+    leaf_values[i] = value;
+    if (value > 0.0f) {
+      openvdb::CoordBBox bbox = leaf.getNodeBoundingBox();
+      bbox.expand(filter_radius);
+      leaf_bboxes[i] = volume_majorant_object_bbox(transform, bbox);
+    }
+  });
+
+  for (size_t i = 0; i < num_leaves; i++) {
+    if (leaf_values[i] > 0.0f) {
+      volume_majorant_grid_add(majorant, inv_cell_size, leaf_bboxes[i], leaf_values[i]);
+    }
+  }
+
+  /* Active tiles above the leaf level. */
+  openvdb::FloatGrid::ValueOnCIter iter = grid->cbeginValueOn();
+  iter.setMaxDepth(openvdb::FloatGrid::ValueOnCIter::LEAF_DEPTH - 1);
+  for (; iter; ++iter) {
+    const float value = *iter;
+    if (value > 0.0f) {
+      openvdb::CoordBBox bbox;
+      iter.getBoundingBox(bbox);
+      bbox.expand(filter_radius);
+      volume_majorant_grid_add(
+          majorant, inv_cell_size, volume_majorant_object_bbox(transform, bbox), value);
+    }
+  }
+}
 #endif
 
 /* ************************************************************************** */
@@ -676,6 +795,10 @@ void GeometryManager::create_volume_mesh(const Scene *scene, Volume *volume, Pro
   VolumeMeshBuilder builder;
 
 #ifdef WITH_OPENVDB
+  /* Radius of the interpolation filter, before adding padding for motion. */
+  const int filter_radius = max(pad_size, 1);
+  openvdb::FloatGrid::ConstPtr density_grid;
+
   merge_scalar_grids_for_velocity(scene, volume);
 
   for (Attribute &attr : volume->attributes.attributes) {
@@ -723,6 +846,10 @@ void GeometryManager::create_volume_mesh(const Scene *scene, Volume *volume, Pro
       }
 
       builder.add_grid(grid, do_clipping, volume->get_clipping());
+
+      if (attr.std == ATTR_STD_VOLUME_DENSITY && grid->isType<openvdb::FloatGrid>()) {
+        density_grid = openvdb::gridConstPtrCast<openvdb::FloatGrid>(grid);
+      }
     }
   }
 #else
@@ -768,6 +895,19 @@ void GeometryManager::create_volume_mesh(const Scene *scene, Volume *volume, Pro
     fN[i] = face_normals[i];
   }
 
+#ifdef WITH_OPENVDB
+  /* Create majorant grid for delta tracking, only when it is used since this visits all active
+   * voxels of the density grid. */
+  volume->majorant_grid.clear();
+  if (density_grid && scene->integrator->get_use_volume_delta_tracking()) {
+    BoundBox bounds = BoundBox::empty;
+    for (const float3 &vertex : vertices) {
+      bounds.grow(vertex);
+    }
+    volume_majorant_grid_build(volume->majorant_grid, density_grid, bounds, filter_radius);
+  }
+#endif
+
   /* Print stats. */
   VLOG_WORK << "Memory usage volume mesh: "
             << ((vertices.size() + face_normals.size()) * sizeof(float3) +
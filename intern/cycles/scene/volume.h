@@ -10,6 +10,26 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Coarse grid storing the maximum density in each cell, used to bound the extinction for
+ * delta tracking. Cells cover the bounds of the volume mesh in object space. */
+struct VolumeMajorantGrid {
+  int3 resolution = make_int3(0, 0, 0);
+  BoundBox bounds = BoundBox::empty;
+  vector<float> cells;
+
+  bool empty() const
+  {
+    return cells.empty();
+  }
+
+  void clear()
+  {
+    resolution = make_int3(0, 0, 0);
+    bounds = BoundBox::empty;
+    cells.clear();
+  }
+};
+
 class Volume : public Mesh {
  public:
   NODE_DECLARE
@@ -21,6 +41,9 @@ class Volume : public Mesh {
   NODE_SOCKET_API(bool, object_space)
   NODE_SOCKET_API(float, velocity_scale)
 
+  /* Built along with the volume mesh, from the density grid. */
+  VolumeMajorantGrid majorant_grid;
+
   virtual void clear(bool preserve_shaders = false) override;
 };
 
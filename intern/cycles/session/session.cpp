@@ -416,7 +416,7 @@ RenderWork Session::run_update_for_next_iteration()
     }
 
     if (update_scene(width, height)) {
-      profiler.reset(scene->shaders.size(), scene->objects.size());
+      profiler.reset(scene->shaders.size(), scene->objects.size(), scene->lights.size());
     }
 
     /* Unlock scene mutex before loading denoiser kernels, since that may attempt to activate
@@ -545,6 +545,7 @@ void Session::do_delayed_reset()
 
   /* Update for new state of scene and passes. */
   buffer_params_.update_passes(scene->passes);
+  tile_manager_.set_use_half_float_passes(params.use_half_float_tile_passes);
   tile_manager_.update(buffer_params_, scene);
 
   /* Update temp directory on reset.
@@ -59,6 +59,9 @@ class SessionParams {
   bool use_auto_tile;
   int tile_size;
 
+  /* Write smaller tile files, storing data passes as half floats. */
+  bool use_half_float_tile_passes;
+
   bool use_resolution_divider;
 
   ShadingSystem shadingsystem;
@@ -82,6 +85,7 @@ class SessionParams {
 
     use_auto_tile = true;
     tile_size = 2048;
+    use_half_float_tile_passes = false;
 
     use_resolution_divider = true;
 
@@ -96,7 +100,8 @@ class SessionParams {
              background == params.background && experimental == params.experimental &&
              pixel_size == params.pixel_size && threads == params.threads &&
              use_profiling == params.use_profiling && shadingsystem == params.shadingsystem &&
-             use_auto_tile == params.use_auto_tile && tile_size == params.tile_size);
+             use_auto_tile == params.use_auto_tile && tile_size == params.tile_size &&
+             use_half_float_tile_passes == params.use_half_float_tile_passes);
   }
 };
 
@@ -33,6 +33,10 @@ static const char *ATTR_PASS_SOCKET_PREFIX_FORMAT = "cycles.passes.%d.";
 static const char *ATTR_BUFFER_SOCKET_PREFIX = "cycles.buffer.";
 static const char *ATTR_DENOISE_SOCKET_PREFIX = "cycles.denoise.";
 
+/* Maximum number of samples for which passes stored as half floats can not overflow, matches the
+ * largest finite half float value. */
+static const int HALF_FLOAT_MAX_SAMPLES = 65504;
+
 /* Global counter of ToleManager object instances. */
 static std::atomic<uint64_t> g_instance_index = 0;
 
@@ -71,6 +75,60 @@ static std::vector<std::string> exr_channel_names_for_passes(const BufferParams
   return channel_names;
 }
 
+/* Check whether the pass can be stored with half float precision in the tile file.
+ *
+ * Only passes with values bounded to the [-1, 1] range per sample qualify, so that the accumulated
+ * value stays representable for the sample counts which are allowed to use half floats. Passes
+ * like depth, object and material index, or cryptomatte (where the identifier is stored as the
+ * bit pattern of a float) require full float precision. */
+static bool pass_use_half_float(const BufferPass &pass)
+{
+  switch (pass.type) {
+    case PASS_NORMAL:
+    case PASS_ROUGHNESS:
+    case PASS_DENOISING_NORMAL:
+    case PASS_DENOISING_ALBEDO:
+      return true;
+    default:
+      break;
+  }
+  return false;
+}
+
+/* Construct per-channel formats matching the channels from exr_channel_names_for_passes().
+ *
+ * Returns an empty vector if all channels are to be stored as floats. */
+static std::vector<TypeDesc> exr_channel_formats_for_passes(const BufferParams &buffer_params,
+                                                            const bool use_half_float_passes)
+{
+  std::vector<TypeDesc> channel_formats;
+  if (!use_half_float_passes) {
+    return channel_formats;
+  }
+
+  bool has_half_float_channel = false;
+  for (const BufferPass &pass : buffer_params.passes) {
+    if (pass.offset == PASS_UNUSED) {
+      continue;
+    }
+
+    const PassInfo pass_info = pass.get_info();
+    const bool use_half_float = pass_use_half_float(pass);
+
+    for (int i = 0; i < pass_info.num_components; ++i) {
+      channel_formats.push_back(use_half_float ? TypeDesc::HALF : TypeDesc::FLOAT);
+    }
+
+    has_half_float_channel |= use_half_float;
+  }
+
+  if (!has_half_float_channel) {
+    channel_formats.clear();
+  }
+
+  return channel_formats;
+}
+
 inline string node_socket_attribute_name(const SocketType &socket, const string &attr_name_prefix)
 {
   return attr_name_prefix + string(socket.name);
@@ -275,10 +333,14 @@ static bool buffer_params_from_image_spec_atttributes(BufferParams *buffer_param
  * metadata will be set so that the render buffers and passes can be reconstructed from it.
  *
  * If the tile size different from (0, 0) the image specification will be configured to use the
- * given tile size for tiled IO. */
+ * given tile size for tiled IO.
+ *
+ * Pixels are always passed to and from the file as floats, OIIO takes care of the conversion of
+ * channels which are stored as half floats. */
 static bool configure_image_spec_from_buffer(ImageSpec *image_spec,
                                              const BufferParams &buffer_params,
-                                             const int2 tile_size = make_int2(0, 0))
+                                             const int2 tile_size = make_int2(0, 0),
+                                             const bool use_half_float_passes = false)
 {
   const std::vector<std::string> channel_names = exr_channel_names_for_passes(buffer_params);
   const int num_channels = channel_names.size();
@@ -287,6 +349,8 @@ static bool configure_image_spec_from_buffer(ImageSpec *image_spec,
       buffer_params.width, buffer_params.height, num_channels, TypeDesc::FLOAT);
 
   image_spec->channelnames = std::move(channel_names);
+  image_spec->channelformats = exr_channel_formats_for_passes(buffer_params,
+                                                              use_half_float_passes);
 
   if (!buffer_params_to_image_spec_atttributes(image_spec, buffer_params)) {
     return false;
@@ -359,7 +423,14 @@ void TileManager::update(const BufferParams &params, const Scene *scene)
   if (has_multiple_tiles()) {
     /* TODO(sergey): Proper Error handling, so that if configuration has failed we don't attempt to
      * write to a partially configured file. */
-    configure_image_spec_from_buffer(&write_state_.image_spec, buffer_params_, tile_size_);
+    /* Accumulated per-sample values of the half float passes are bounded by the number of
+     * samples, so only use half floats when it is guaranteed to not overflow. */
+    const bool use_half_float_passes = use_half_float_passes_ &&
+                                       scene->integrator->get_aa_samples() <=
+                                           HALF_FLOAT_MAX_SAMPLES;
+
+    configure_image_spec_from_buffer(
+        &write_state_.image_spec, buffer_params_, tile_size_, use_half_float_passes);
 
     const DenoiseParams denoise_params = scene->integrator->get_denoise_params();
     const AdaptiveSampling adaptive_sampling = scene->integrator->get_adaptive_sampling();
@@ -387,6 +458,11 @@ void TileManager::set_temp_dir(const string &temp_dir)
   temp_dir_ = temp_dir;
 }
 
+void TileManager::set_use_half_float_passes(bool use_half_float_passes)
+{
+  use_half_float_passes_ = use_half_float_passes;
+}
+
 bool TileManager::done()
 {
   return tile_state_.next_tile_index == tile_state_.num_tiles;
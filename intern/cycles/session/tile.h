@@ -59,6 +59,11 @@ class TileManager {
 
   void set_temp_dir(const string &temp_dir);
 
+  /* Store data passes (normal, albedo, roughness) as half float in the tile file, which reduces
+   * the file size and the time spent on writing tiles. The render buffers in memory are not
+   * affected. Needs to be set before update() to have effect on the next tile file. */
+  void set_use_half_float_passes(bool use_half_float_passes);
+
   inline int get_num_tiles() const
   {
     return tile_state_.num_tiles;
@@ -126,6 +131,8 @@ class TileManager {
 
   string temp_dir_;
 
+  bool use_half_float_passes_ = false;
+
   /* Part of an on-disk tile file name which avoids conflicts between several Cycles instances or
    * several sessions. */
   string tile_file_unique_part_;
@@ -8,8 +8,32 @@
 #include "subd/dice.h"
 #include "subd/patch.h"
 
+#include "util/hash.h"
+#include "util/tbb.h"
+
 CCL_NAMESPACE_BEGIN
 
+/* Number of subpatches diced by a single task. */
+static const int SUBPATCHES_PER_TASK = 64;
+
+/* Dicing Cache */
+
+bool SubdDicingCache::Key::operator==(const Key &other) const
+{
+  return patch_index == other.patch_index && Mu == other.Mu && Mv == other.Mv &&
+         corners[0] == other.corners[0] && corners[1] == other.corners[1] &&
+         corners[2] == other.corners[2] && corners[3] == other.corners[3];
+}
+
+size_t SubdDicingCache::KeyHasher::operator()(const Key &key) const
+{
+  uint hash = hash_uint3(key.patch_index, key.Mu, key.Mv);
+  for (int i = 0; i < 4; i++) {
+    hash = hash_uint3(hash, __float_as_uint(key.corners[i].x), __float_as_uint(key.corners[i].y));
+  }
+  return hash;
+}
+
 /* EdgeDice Base */
 
 EdgeDice::EdgeDice(const SubdParams &params_) : params(params_)
@@ -33,8 +57,12 @@ void EdgeDice::reserve(int num_verts, int num_triangles)
   vert_offset = mesh->get_verts().size();
   tri_offset = mesh->num_triangles();
 
-  mesh->resize_mesh(mesh->get_verts().size() + num_verts, mesh->num_triangles());
-  mesh->reserve_mesh(mesh->get_verts().size() + num_verts, mesh->num_triangles() + num_triangles);
+  mesh->resize_mesh(mesh->get_verts().size() + num_verts, mesh->num_triangles() + num_triangles);
+
+  mesh->tag_triangles_modified();
+  mesh->tag_shader_modified();
+  mesh->tag_smooth_modified();
+  mesh->tag_triangle_patch_modified();
 
   Attribute *attr_vN = mesh->attributes.add(ATTR_STD_VERTEX_NORMAL);
 
@@ -57,17 +85,22 @@ void EdgeDice::set_vert(Patch *patch, int index, float2 uv)
   params.mesh->vert_patch_uv[index + vert_offset] = make_float2(uv.x, uv.y);
 }
 
-void EdgeDice::add_triangle(Patch *patch, int v0, int v1, int v2)
+void EdgeDice::add_triangle(Patch *patch, int triangle, int v0, int v1, int v2)
 {
   Mesh *mesh = params.mesh;
+  const size_t index = tri_offset + triangle;
 
-  mesh->add_triangle(v0 + vert_offset, v1 + vert_offset, v2 + vert_offset, patch->shader, true);
-  params.mesh->triangle_patch[params.mesh->num_triangles() - 1] = patch->patch_index;
+  assert(index < mesh->num_triangles());
 
-  tri_offset++;
+  mesh->triangles[index * 3 + 0] = v0 + vert_offset;
+  mesh->triangles[index * 3 + 1] = v1 + vert_offset;
+  mesh->triangles[index * 3 + 2] = v2 + vert_offset;
+  mesh->shader[index] = patch->shader;
+  mesh->smooth[index] = true;
+  mesh->triangle_patch[index] = patch->patch_index;
 }
 
-void EdgeDice::stitch_triangles(Subpatch &sub, int edge)
+int EdgeDice::stitch_triangles(Subpatch &sub, int edge, int triangle)
 {
   int Mu = max(sub.edge_u0.T, sub.edge_u1.T);
   int Mv = max(sub.edge_v0.T, sub.edge_v1.T);
@@ -78,7 +111,7 @@ void EdgeDice::stitch_triangles(Subpatch &sub, int edge)
   int inner_T = ((edge % 2) == 0) ? Mv - 2 : Mu - 2;
 
   if (inner_T < 0 || outer_T < 0) {
-    return;  // XXX avoid crashes for Mu or Mv == 1, missing polygons
+    return triangle;  // XXX avoid crashes for Mu or Mv == 1, missing polygons
   }
 
   /* stitch together two arrays of verts with triangles. at each step,
@@ -113,8 +146,10 @@ void EdgeDice::stitch_triangles(Subpatch &sub, int edge)
       }
     }
 
-    add_triangle(sub.patch, v1, v0, v2);
+    add_triangle(sub.patch, triangle++, v1, v0, v2);
   }
+
+  return triangle;
 }
 
 /* QuadDice */
@@ -216,7 +251,13 @@ float QuadDice::scale_factor(Subpatch &sub, int Mu, int Mv)
   return S;
 }
 
-void QuadDice::add_grid(Subpatch &sub, int Mu, int Mv, int offset)
+int QuadDice::add_grid(Subpatch &sub,
+                       int Mu,
+                       int Mv,
+                       int offset,
+                       int triangle,
+                       const SubdDicingCache::Grid *cached_grid,
+                       SubdDicingCache::Grid *grid)
 {
   /* create inner grid */
   float du = 1.0f / (float)Mu;
@@ -227,7 +268,17 @@ void QuadDice::add_grid(Subpatch &sub, int Mu, int Mv, int offset)
       float u = i * du;
       float v = j * dv;
 
-      set_vert(sub, offset + (i - 1) + (j - 1) * (Mu - 1), u, v);
+      const int index = offset + (i - 1) + (j - 1) * (Mu - 1);
+
+      if (cached_grid) {
+        const int grid_index = (i - 1) + (j - 1) * (Mu - 1);
+        mesh_P[index] = cached_grid->P[grid_index];
+        mesh_N[index] = cached_grid->N[grid_index];
+        params.mesh->vert_patch_uv[index + vert_offset] = map_uv(sub, u, v);
+      }
+      else {
+        set_vert(sub, index, u, v);
+      }
 
       if (i < Mu - 1 && j < Mv - 1) {
         int i1 = offset + (i - 1) + (j - 1) * (Mu - 1);
@@ -235,18 +286,26 @@ void QuadDice::add_grid(Subpatch &sub, int Mu, int Mv, int offset)
         int i3 = offset + i + j * (Mu - 1);
         int i4 = offset + (i - 1) + j * (Mu - 1);
 
-        add_triangle(sub.patch, i1, i2, i3);
-        add_triangle(sub.patch, i1, i3, i4);
+        add_triangle(sub.patch, triangle++, i1, i2, i3);
+        add_triangle(sub.patch, triangle++, i1, i3, i4);
       }
     }
   }
+
+  if (grid) {
+    const int num_verts = (Mu - 1) * (Mv - 1);
+    grid->P.assign(mesh_P + offset, mesh_P + offset + num_verts);
+    grid->N.assign(mesh_N + offset, mesh_N + offset + num_verts);
+  }
+
+  return triangle;
 }
 
-void QuadDice::dice(Subpatch &sub)
+void QuadDice::grid_size(Subpatch &sub, int &Mu, int &Mv)
 {
   /* compute inner grid size with scale factor */
-  int Mu = max(sub.edge_u0.T, sub.edge_u1.T);
-  int Mv = max(sub.edge_v0.T, sub.edge_v1.T);
+  Mu = max(sub.edge_u0.T, sub.edge_u1.T);
+  Mv = max(sub.edge_v0.T, sub.edge_v1.T);
 
 #if 0 /* Doesn't work very well, especially at grazing angles. */
   float S = scale_factor(sub, ef, Mu, Mv);
@@ -256,20 +315,90 @@ void QuadDice::dice(Subpatch &sub)
 
   Mu = max((int)ceilf(S * Mu), 2);  // XXX handle 0 & 1?
   Mv = max((int)ceilf(S * Mv), 2);  // XXX handle 0 & 1?
+}
 
-  /* inner grid */
-  add_grid(sub, Mu, Mv, sub.inner_grid_vert_offset);
+void QuadDice::dice(vector<Subpatch> &subpatches)
+{
+  SubdDicingCache *cache = params.use_dicing_cache ? params.mesh->subd_dicing_cache : nullptr;
+  vector<SubdDicingCache::Key> keys;
+  vector<SubdDicingCache::Grid> grids;
 
-  /* sides */
-  set_side(sub, 0);
-  set_side(sub, 1);
-  set_side(sub, 2);
-  set_side(sub, 3);
+  if (cache) {
+    keys.resize(subpatches.size());
+    grids.resize(subpatches.size());
+  }
 
-  stitch_triangles(sub, 0);
-  stitch_triangles(sub, 1);
-  stitch_triangles(sub, 2);
-  stitch_triangles(sub, 3);
+  /* Inner grids only share vertices with the sides, so they can be diced in parallel. */
+  parallel_for(
+      blocked_range<size_t>(0, subpatches.size(), SUBPATCHES_PER_TASK),
+      [&](const blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i != range.end(); i++) {
+          Subpatch &sub = subpatches[i];
+
+          int Mu, Mv;
+          grid_size(sub, Mu, Mv);
+
+          const SubdDicingCache::Grid *cached_grid = nullptr;
+          SubdDicingCache::Grid *grid = nullptr;
+
+          if (cache) {
+            SubdDicingCache::Key &key = keys[i];
+            key.patch_index = sub.patch->patch_index;
+            key.Mu = Mu;
+            key.Mv = Mv;
+            for (int j = 0; j < 4; j++) {
+              key.corners[j] = sub.corners[j];
+            }
+
+            auto it = cache->grids.find(key);
+            if (it != cache->grids.end()) {
+              cached_grid = &it->second;
+            }
+            grid = &grids[i];
+          }
+
+          add_grid(sub,
+                   Mu,
+                   Mv,
+                   sub.inner_grid_vert_offset,
+                   sub.triangle_offset,
+                   cached_grid,
+                   grid);
+        }
+      });
+
+  /* Sides are shared between neighboring subpatches, set them in order so that the vertices of
+   * shared edges are deterministic. */
+  for (Subpatch &sub : subpatches) {
+    set_side(sub, 0);
+    set_side(sub, 1);
+    set_side(sub, 2);
+    set_side(sub, 3);
+  }
+
+  /* Stitching only reads vertices, and writes the triangles following the inner grid. */
+  parallel_for(blocked_range<size_t>(0, subpatches.size(), SUBPATCHES_PER_TASK),
+               [&](const blocked_range<size_t> &range) {
+                 for (size_t i = range.begin(); i != range.end(); i++) {
+                   Subpatch &sub = subpatches[i];
+
+                   int Mu, Mv;
+                   grid_size(sub, Mu, Mv);
+
+                   int triangle = sub.triangle_offset + (Mu - 2) * (Mv - 2) * 2;
+                   for (int edge = 0; edge < 4; edge++) {
+                     triangle = stitch_triangles(sub, edge, triangle);
+                   }
+                 }
+               });
+
+  /* Only keep the grids of this tessellation, to not accumulate grids of older ones. */
+  if (cache) {
+    cache->grids.clear();
+    for (size_t i = 0; i < subpatches.size(); i++) {
+      cache->grids.emplace(keys[i], std::move(grids[i]));
+    }
+  }
 }
 
 CCL_NAMESPACE_END
@@ -10,6 +10,7 @@
  * DiagSplit. For more algorithm details, see the DiagSplit paper or the
  * ARB_tessellation_shader OpenGL extension, Section 2.X.2. */
 
+#include "util/map.h"
 #include "util/types.h"
 #include "util/vector.h"
 
@@ -31,6 +32,7 @@ struct SubdParams {
   int max_level;
   Camera *camera;
   Transform objecttoworld;
+  bool use_dicing_cache;
 
   SubdParams(Mesh *mesh_, bool ptex_ = false)
   {
@@ -42,9 +44,41 @@ struct SubdParams {
     dicing_rate = 1.0f;
     max_level = 12;
     camera = NULL;
+    use_dicing_cache = false;
   }
 };
 
+/* Dicing Cache
+ *
+ * Inner grid vertices of the diced subpatches, kept in the mesh between tessellations. As long
+ * as the control mesh is unchanged, a subpatch with the same patch, corners and grid resolution
+ * as in the previous tessellation copies its vertices from the cache instead of evaluating the
+ * patch again. Edge factors only change where the dicing camera moved enough to change them, so
+ * most of the grids can be reused across frames. */
+
+struct SubdDicingCache {
+  struct Key {
+    int patch_index;
+    float2 corners[4];
+    int Mu, Mv;
+
+    bool operator==(const Key &other) const;
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Grid {
+    vector<float3> P;
+    vector<float3> N;
+  };
+
+  /* Hash of the control mesh and patch evaluation settings the grids were evaluated with. */
+  uint mesh_hash = 0;
+  unordered_map<Key, Grid, KeyHasher> grids;
+};
+
 /* EdgeDice Base */
 
 class EdgeDice {
@@ -60,9 +94,12 @@ class EdgeDice {
   void reserve(int num_verts, int num_triangles);
 
   void set_vert(Patch *patch, int index, float2 uv);
-  void add_triangle(Patch *patch, int v0, int v1, int v2);
+  /* Triangles are written at an index relative to the reserved triangles, so that subpatches
+   * can be diced in parallel. */
+  void add_triangle(Patch *patch, int triangle, int v0, int v1, int v2);
 
-  void stitch_triangles(Subpatch &sub, int edge);
+  /* Returns the index after the last added triangle. */
+  int stitch_triangles(Subpatch &sub, int edge, int triangle);
 };
 
 /* Quad EdgeDice */
@@ -76,14 +113,24 @@ class QuadDice : public EdgeDice {
   float2 map_uv(Subpatch &sub, float u, float v);
   void set_vert(Subpatch &sub, int index, float u, float v);
 
-  void add_grid(Subpatch &sub, int Mu, int Mv, int offset);
+  /* Returns the index after the last added triangle. */
+  int add_grid(Subpatch &sub,
+               int Mu,
+               int Mv,
+               int offset,
+               int triangle,
+               const SubdDicingCache::Grid *cached_grid,
+               SubdDicingCache::Grid *grid);
 
   void set_side(Subpatch &sub, int edge);
 
   float quad_area(const float3 &a, const float3 &b, const float3 &c, const float3 &d);
   float scale_factor(Subpatch &sub, int Mu, int Mv);
 
-  void dice(Subpatch &sub);
+  void grid_size(Subpatch &sub, int &Mu, int &Mv);
+
+  /* Dice all subpatches, with the triangle and inner grid vertex offsets already assigned. */
+  void dice(vector<Subpatch> &subpatches);
 };
 
 CCL_NAMESPACE_END
@@ -9,6 +9,7 @@
 
 #include "scene/colorspace.h"
 #include "scene/scene.h"
+#include "scene/shader.h"
 #include "scene/shader_graph.h"
 #include "scene/shader_nodes.h"
 
@@ -1537,4 +1538,35 @@ TEST_F(RenderGraph, constant_fold_convert_color_float_color)
   graph.finalize(scene);
 }
 
+/*
+ * Tests:
+ *  - Texture coordinate derivatives of image textures with the texture cache are copies of
+ *    the vector sub-graph evaluated as bump dx/dy, so they need bump nodes.
+ */
+TEST_F(RenderGraph, texture_cache_image_derivatives)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  scene->params.use_texture_cache = true;
+
+  builder
+      .add_node(ShaderNodeBuilder<TextureCoordinateNode>(graph, "TexCoord")
+                    .set_param("use_transform", true))
+      .add_node(ShaderNodeBuilder<ImageTextureNode>(graph, "ImageTexture"))
+      .add_connection("TexCoord::Object", "ImageTexture::Vector")
+      .output_color("ImageTexture::Color");
+
+  graph.finalize(scene);
+
+  int num_bump_nodes = 0;
+  foreach (ShaderNode *node, graph.nodes) {
+    if (node->bump != SHADER_BUMP_NONE) {
+      num_bump_nodes++;
+    }
+  }
+  EXPECT_EQ(num_bump_nodes, 2);
+  EXPECT_NE(scene->shader_manager->get_graph_kernel_features(&graph) & KERNEL_FEATURE_NODE_BUMP,
+            0);
+}
+
 CCL_NAMESPACE_END
@@ -29,6 +29,7 @@ void DebugFlags::CPU::reset()
     } \
   } while (0)
 
+  CHECK_CPU_FLAGS(avx512, "CYCLES_CPU_NO_AVX512");
   CHECK_CPU_FLAGS(avx2, "CYCLES_CPU_NO_AVX2");
   CHECK_CPU_FLAGS(sse42, "CYCLES_CPU_NO_SSE42");
 
@@ -36,6 +37,8 @@ void DebugFlags::CPU::reset()
 #undef CHECK_CPU_FLAGS
 
   bvh_layout = BVH_LAYOUT_AUTO;
+  wavefront = (getenv("CYCLES_CPU_WAVEFRONT") != NULL);
+  ray_packets = (getenv("CYCLES_CPU_NO_RAY_PACKETS") == NULL);
 }
 
 DebugFlags::CUDA::CUDA()
@@ -25,12 +25,17 @@ class DebugFlags {
     void reset();
 
     /* Flags describing which instructions sets are allowed for use. */
+    bool avx512 = true;
     bool avx2 = true;
     bool sse42 = true;
 
     /* Check functions to see whether instructions up to the given one
      * are allowed for use.
      */
+    bool has_avx512()
+    {
+      return has_avx2() && avx512;
+    }
     bool has_avx2()
     {
       return has_sse42() && avx2;
@@ -46,6 +51,13 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout = BVH_LAYOUT_AUTO;
+
+    /* Render batches of paths per thread one kernel at a time, sorted by kernel and shader,
+     * instead of rendering every path sample to completion with the megakernel. */
+    bool wavefront = false;
+
+    /* Intersect coherent camera and shadow rays in packets, in wavefront mode. */
+    bool ray_packets = true;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
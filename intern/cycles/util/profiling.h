@@ -63,10 +63,12 @@ struct ProfilingState {
   volatile uint32_t event = PROFILING_UNKNOWN;
   volatile int32_t shader = -1;
   volatile int32_t object = -1;
+  volatile int32_t light = -1;
   volatile bool active = false;
 
   vector<uint64_t> shader_hits;
   vector<uint64_t> object_hits;
+  vector<uint64_t> light_hits;
 };
 
 class Profiler {
@@ -74,7 +76,7 @@ class Profiler {
   Profiler();
   ~Profiler();
 
-  void reset(int num_shaders, int num_objects);
+  void reset(int num_shaders, int num_objects, int num_lights);
 
   void start();
   void stop();
@@ -85,6 +87,7 @@ class Profiler {
   uint64_t get_event(ProfilingEvent event);
   bool get_shader(int shader, uint64_t &samples, uint64_t &hits);
   bool get_object(int object, uint64_t &samples, uint64_t &hits);
+  bool get_light(int light, uint64_t &samples, uint64_t &hits);
 
   bool active() const;
 
@@ -97,13 +100,15 @@ class Profiler {
   vector<uint64_t> event_samples;
   vector<uint64_t> shader_samples;
   vector<uint64_t> object_samples;
+  vector<uint64_t> light_samples;
 
-  /* Tracks the total amounts every object/shader was hit.
+  /* Tracks the total amounts every object/shader/light was hit.
    * Used to evaluate relative cost, written by the render thread.
-   * Indexed by the shader and object IDs that the kernel also uses
-   * to index __object_flag and __shaders. */
+   * Indexed by the shader, object and light IDs that the kernel also uses
+   * to index __object_flag, __shaders and __lights. */
   vector<uint64_t> shader_hits;
   vector<uint64_t> object_hits;
+  vector<uint64_t> light_hits;
 
   volatile bool do_stop_worker;
   thread *worker;
@@ -146,6 +151,7 @@ class ProfilingWithShaderHelper : public ProfilingHelper {
   {
     state->object = -1;
     state->shader = -1;
+    state->light = -1;
   }
 
   inline void set_shader(int object, int shader)
@@ -165,6 +171,18 @@ class ProfilingWithShaderHelper : public ProfilingHelper {
       }
     }
   }
+
+  inline void set_light(int light)
+  {
+    if (state->active) {
+      state->light = light;
+
+      if (light >= 0) {
+        assert(light < state->light_hits.size());
+        state->light_hits[light]++;
+      }
+    }
+  }
 };
 
 CCL_NAMESPACE_END
@@ -476,7 +476,8 @@ __forceinline uint64_t bitscan(uint64_t value)
 
 /* quiet unused define warnings */
 #if defined(__KERNEL_SSE2__) || defined(__KERNEL_SSE3__) || defined(__KERNEL_SSSE3__) || \
-    defined(__KERNEL_SSE42__) || defined(__KERNEL_AVX__) || defined(__KERNEL_AVX2__)
+    defined(__KERNEL_SSE42__) || defined(__KERNEL_AVX__) || defined(__KERNEL_AVX2__) || \
+    defined(__KERNEL_AVX512__)
 /* do nothing */
 #endif
 
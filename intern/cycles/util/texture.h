@@ -40,6 +40,7 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
   IMAGE_DATA_TYPE_NANOVDB_FPN = 10,
   IMAGE_DATA_TYPE_NANOVDB_FP16 = 11,
+  IMAGE_DATA_TYPE_TEXTURE_CACHE = 12,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
@@ -86,6 +87,20 @@ typedef struct TextureInfo {
   Transform transform_3d;
 } TextureInfo;
 
+#ifndef __KERNEL_GPU__
+/* Image sampled on demand through a tiled and mipmapped texture cache on the CPU. For textures
+ * of type IMAGE_DATA_TYPE_TEXTURE_CACHE the texture data holds a pointer to this object instead
+ * of pixels. */
+class TextureCacheImage {
+ public:
+  virtual ~TextureCacheImage() {}
+
+  /* Filtered lookup, the texture coordinate derivatives choose the mip level. Zero derivatives
+   * sample the full resolution image. */
+  virtual float4 lookup(float x, float y, float2 dx, float2 dy) const = 0;
+};
+#endif
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_TEXTURE_H__ */
@@ -1849,6 +1849,11 @@ class USERPREF_PT_saveload_blend(SaveLoadPanel, CenterAlignMixIn, Panel):
         col.prop(paths, "use_file_compression")
         col.prop(paths, "use_load_ui")
 
+        col = layout.column()
+        col.active = paths.use_file_compression
+        col.prop(paths, "file_compression_level")
+        col.prop(paths, "file_compression_threads")
+
         col = layout.column(heading="Text Files")
         col.prop(paths, "use_tabs_as_spaces")
 
@@ -2937,6 +2942,8 @@ class USERPREF_PT_experimental_debugging(ExperimentalPanel, Panel):
                 ({"property": "use_cycles_debug"}, None),
                 ({"property": "show_asset_debug_info"}, None),
                 ({"property": "use_asset_indexing"}, None),
+                ({"property": "use_blend_file_index"}, None),
+                ({"property": "use_undo_disk_spill"}, None),
                 ({"property": "use_viewport_debug"}, None),
                 ({"property": "use_eevee_debug"}, None),
                 ({"property": "use_extensions_debug"}, ("/blender/blender/issues/119521", "#119521")),
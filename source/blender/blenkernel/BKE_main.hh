@@ -182,6 +182,12 @@ struct Main {
    */
   bool is_read_invalid;
 
+  /**
+   * Only the data-blocks used by the active scene and the UI were read from the file
+   * (see #BLO_READ_SKIP_UNUSED_IDS). Writing it back would lose all the other ones.
+   */
+  bool is_partially_read;
+
   /**
    * True if this main is the 'GMAIN' of current Blender.
    *
@@ -24,6 +24,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "CLG_log.h"
+
 #include "DNA_scene_types.h"
 
 #include "BLI_path_utils.hh"
@@ -44,6 +46,8 @@
 
 #include "DEG_depsgraph.hh"
 
+static CLG_LogRef LOG = {"bke.blender_undo"};
+
 /* -------------------------------------------------------------------- */
 /** \name Global Undo
  * \{ */
@@ -74,6 +78,10 @@ bool BKE_memfile_undo_decode(MemFileUndoData *mfu,
     }
   }
   else {
+    if (!BLO_memfile_unspill(&mfu->memfile)) {
+      CLOG_ERROR(&LOG, "Failed to read back undo step data written to disk");
+    }
+    mfu->undo_size = mfu->memfile.size;
     BlendFileReadParams params = {0};
     params.undo_direction = undo_direction;
     if (!use_old_bmain_data) {
@@ -131,6 +139,9 @@ MemFileUndoData *BKE_memfile_undo_encode(Main *bmain, MemFileUndoData *mfu_prev)
   else {
     MemFile *prevfile = (mfu_prev) ? &(mfu_prev->memfile) : nullptr;
     if (prevfile) {
+      /* The previous step is the reference for detecting unchanged chunks. */
+      BLO_memfile_unspill(prevfile);
+      mfu_prev->undo_size = prevfile->size;
       BLO_memfile_clear_future(prevfile);
     }
     /* success = */ /* UNUSED */ BLO_write_file_mem(bmain, prevfile, &mfu->memfile, fileflags);
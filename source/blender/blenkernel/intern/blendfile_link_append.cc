@@ -31,6 +31,7 @@
 #include "BLI_linklist.h"
 #include "BLI_math_vector.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -118,6 +119,26 @@ static BlendHandle *link_append_context_library_blohandle_ensure(
   return blo_handle;
 }
 
+/**
+ * Open the files of all libraries of the context at once. Opening a blend-file is mostly waiting
+ * on I/O, so this is much faster than opening them one after the other when linking from many
+ * libraries, especially from network storage.
+ */
+static void link_append_context_library_blohandles_ensure_parallel(
+    BlendfileLinkAppendContext &lapp_context, ReportList *reports)
+{
+  if (lapp_context.libraries.size() < 2) {
+    return;
+  }
+  blender::threading::parallel_for(
+      lapp_context.libraries.index_range(), 1, [&](const blender::IndexRange range) {
+        for (const int lib_idx : range) {
+          link_append_context_library_blohandle_ensure(
+              lapp_context, lapp_context.libraries[lib_idx], reports);
+        }
+      });
+}
+
 static void link_append_context_library_blohandle_release(
     BlendfileLinkAppendContext & /*lapp_context*/, BlendfileLinkAppendContextLibrary &lib_context)
 {
@@ -1536,6 +1557,8 @@ void BKE_blendfile_link(BlendfileLinkAppendContext *lapp_context, ReportList *re
   Main *mainl;
   Library *lib;
 
+  link_append_context_library_blohandles_ensure_parallel(*lapp_context, reports);
+
   for (const int lib_idx : lapp_context->libraries.index_range()) {
     BlendfileLinkAppendContextLibrary &lib_context = lapp_context->libraries[lib_idx];
     const char *libname = lib_context.path.c_str();
@@ -1594,7 +1594,14 @@ void CurvesGeometry::blend_read(BlendDataReader &reader)
 
   if (this->curve_offsets) {
     this->runtime->curve_offsets_sharing_info = BLO_read_shared(
-        &reader, &this->curve_offsets, [&]() {
+        &reader, &this->curve_offsets, [&]() -> const ImplicitSharingInfo * {
+          if (const ImplicitSharingInfo *sharing_info = BLO_read_mapped_array(
+                  &reader,
+                  reinterpret_cast<void **>(&this->curve_offsets),
+                  sizeof(int) * size_t(this->curve_num + 1)))
+          {
+            return sharing_info;
+          }
           BLO_read_int32_array(&reader, this->curve_num + 1, &this->curve_offsets);
           return implicit_sharing::info_for_mem_free(this->curve_offsets);
         });
@@ -5463,6 +5463,21 @@ static void blend_read_layer_data(BlendDataReader *reader, CustomDataLayer &laye
   }
 }
 
+/**
+ * Reference the data of layers without per-element allocations directly from the file when
+ * possible, see #BLO_read_mapped_array.
+ */
+static const ImplicitSharingInfo *blend_read_layer_data_mapped(BlendDataReader *reader,
+                                                               CustomDataLayer &layer,
+                                                               const int count)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(eCustomDataType(layer.type));
+  if (typeInfo->copy != nullptr || typeInfo->free != nullptr) {
+    return nullptr;
+  }
+  return BLO_read_mapped_array(reader, &layer.data, size_t(count) * size_t(typeInfo->size));
+}
+
 void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int count)
 {
   BLO_read_struct_array(reader, CustomDataLayer, data->totlayer, &data->layers);
@@ -5488,6 +5503,11 @@ void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int
     if (CustomData_verify_versions(data, i)) {
       layer->sharing_info = BLO_read_shared(
           reader, &layer->data, [&]() -> const ImplicitSharingInfo * {
+            if (const ImplicitSharingInfo *sharing_info = blend_read_layer_data_mapped(
+                    reader, *layer, count))
+            {
+              return sharing_info;
+            }
             blend_read_layer_data(reader, *layer, count);
             if (layer->data == nullptr) {
               return nullptr;
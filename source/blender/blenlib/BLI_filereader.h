@@ -28,6 +28,7 @@ extern "C" {
 #endif
 
 struct FileReader;
+struct BLI_mmap_file;
 
 typedef int64_t (*FileReaderReadFn)(struct FileReader *reader, void *buffer, size_t size);
 typedef off64_t (*FileReaderSeekFn)(struct FileReader *reader, off64_t offset, int whence);
@@ -54,6 +55,13 @@ typedef struct FileReader {
 FileReader *BLI_filereader_new_file(int filedes) ATTR_WARN_UNUSED_RESULT;
 /** Create #FileReader from raw file descriptor using memory-mapped IO. */
 FileReader *BLI_filereader_new_mmap(int filedes) ATTR_WARN_UNUSED_RESULT;
+/**
+ * Create #FileReader from an existing memory-mapped file.
+ * Unlike #BLI_filereader_new_mmap, the reader doesn't take ownership of \a mmap_file,
+ * so the mapped memory can be used after closing the reader.
+ */
+FileReader *BLI_filereader_new_mmap_file(struct BLI_mmap_file *mmap_file)
+    ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 /** Create #FileReader from a region of memory. */
 FileReader *BLI_filereader_new_memory(const void *data, size_t len) ATTR_WARN_UNUSED_RESULT
     ATTR_NONNULL();
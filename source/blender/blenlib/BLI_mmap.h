@@ -26,12 +26,23 @@ typedef struct BLI_mmap_file BLI_mmap_file;
  * Note that this seeks to the end of the file to determine its length. */
 BLI_mmap_file *BLI_mmap_open(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
 
+/* Same as #BLI_mmap_open, but the mapped memory is writable. The mapping is private, writing
+ * to it makes a copy of the affected pages and never changes the file. */
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
 /* Reads length bytes from file at the given offset into dest.
  * Returns whether the operation was successful (may fail when reading beyond the file
  * end or when IO errors occur). */
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
     ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
 
+/* Loads the given range of the file, so the mapped memory can be accessed directly.
+ * Returns whether the operation was successful, like #BLI_mmap_read. IO errors when the memory is
+ * accessed later on are not reported: the memory reads as zeroes, or the access crashes on
+ * Windows. */
+bool BLI_mmap_prefetch(BLI_mmap_file *file, size_t offset, size_t length)
+    ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 size_t BLI_mmap_get_length(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
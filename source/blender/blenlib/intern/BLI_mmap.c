@@ -9,6 +9,7 @@
 #include "BLI_mmap.h"
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
+#include "BLI_threads.h"
 #include "MEM_guardedalloc.h"
 
 #include <string.h>
@@ -33,6 +34,9 @@ struct BLI_mmap_file {
   /* Platform-specific handle for the mapping. */
   void *handle;
 
+  /* Whether the mapped memory is writable, see #BLI_mmap_open_copy_on_write. */
+  bool copy_on_write;
+
   /* Flag to indicate IO errors. Needs to be volatile since it's being set from
    * within the signal handler, which is not part of the normal execution flow. */
   volatile bool io_error;
@@ -58,6 +62,11 @@ static struct error_handler_data {
   void (*next_handler)(int, siginfo_t *, void *);
 } error_handler = {0};
 
+/* Files may be opened from multiple threads (e.g. when reading libraries in parallel), guards the
+ * handler setup and the list of open files. The signal handler itself does not lock it, since it
+ * may interrupt a thread holding the lock. */
+static ThreadMutex error_handler_mutex = BLI_MUTEX_INITIALIZER;
+
 static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 {
   /* We only handle SIGBUS here for now. */
@@ -74,7 +83,12 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 
       /* Replace the mapped memory with zeroes. */
       const void *mapped_memory = mmap(
-          file->memory, file->length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+          file->memory,
+          file->length,
+          file->copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ,
+          MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+          -1,
+          0);
       if (mapped_memory == MAP_FAILED) {
         fprintf(stderr, "SIGBUS handler: Error replacing mapped file with zeros\n");
       }
@@ -96,6 +110,7 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 /* Ensures that the error handler is set up and ready. */
 static bool sigbus_handler_setup(void)
 {
+  BLI_mutex_lock(&error_handler_mutex);
   if (!error_handler.configured) {
     struct sigaction newact = {0}, oldact = {0};
 
@@ -103,6 +118,7 @@ static bool sigbus_handler_setup(void)
     newact.sa_flags = SA_SIGINFO;
 
     if (sigaction(SIGBUS, &newact, &oldact)) {
+      BLI_mutex_unlock(&error_handler_mutex);
       return false;
     }
 
@@ -111,6 +127,7 @@ static bool sigbus_handler_setup(void)
     error_handler.next_handler = oldact.sa_sigaction;
     error_handler.configured = 1;
   }
+  BLI_mutex_unlock(&error_handler_mutex);
 
   return true;
 }
@@ -118,18 +135,24 @@ static bool sigbus_handler_setup(void)
 /* Adds a file to the list that the error handler checks. */
 static void sigbus_handler_add(BLI_mmap_file *file)
 {
-  BLI_addtail(&error_handler.open_mmaps, BLI_genericNodeN(file));
+  LinkData *link = BLI_genericNodeN(file);
+  BLI_mutex_lock(&error_handler_mutex);
+  BLI_addtail(&error_handler.open_mmaps, link);
+  BLI_mutex_unlock(&error_handler_mutex);
 }
 
 /* Removes a file from the list that the error handler checks. */
 static void sigbus_handler_remove(BLI_mmap_file *file)
 {
+  BLI_mutex_lock(&error_handler_mutex);
   LinkData *link = BLI_findptr(&error_handler.open_mmaps, file, offsetof(LinkData, data));
-  BLI_freelinkN(&error_handler.open_mmaps, link);
+  BLI_remlink(&error_handler.open_mmaps, link);
+  BLI_mutex_unlock(&error_handler_mutex);
+  MEM_freeN(link);
 }
 #endif
 
-BLI_mmap_file *BLI_mmap_open(int fd)
+static BLI_mmap_file *mmap_open(int fd, const bool copy_on_write)
 {
   void *memory, *handle = NULL;
   const size_t length = BLI_lseek(fd, 0, SEEK_END);
@@ -144,7 +167,8 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   }
 
   /* Map the given file to memory. */
-  memory = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  memory = mmap(
+      NULL, length, copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
   if (memory == MAP_FAILED) {
     return NULL;
   }
@@ -154,11 +178,12 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   /* Memory mapping on Windows is a two-step process - first we create a mapping,
    * then we create a view into that mapping.
    * In our case, one view that spans the entire file is enough. */
-  handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  handle = CreateFileMapping(
+      file_handle, NULL, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
   if (handle == NULL) {
     return NULL;
   }
-  memory = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+  memory = MapViewOfFile(handle, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
   if (memory == NULL) {
     CloseHandle(handle);
     return NULL;
@@ -170,6 +195,7 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   file->memory = memory;
   file->handle = handle;
   file->length = length;
+  file->copy_on_write = copy_on_write;
 
 #ifndef WIN32
   /* Register the file with the error handler. */
@@ -179,6 +205,16 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   return file;
 }
 
+BLI_mmap_file *BLI_mmap_open(int fd)
+{
+  return mmap_open(fd, false);
+}
+
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd)
+{
+  return mmap_open(fd, true);
+}
+
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
 {
   /* If a previous read has already failed or we try to read past the end,
@@ -208,6 +244,47 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
   return !file->io_error;
 }
 
+/* Read one byte of every page in the range, so it is loaded from the file. */
+static void mmap_touch_pages(const char *memory, size_t length)
+{
+  const size_t page_size = 4096;
+  volatile char value;
+  for (size_t i = 0; i < length; i += page_size) {
+    value = memory[i];
+  }
+  value = memory[length - 1];
+  UNUSED_VARS(value);
+}
+
+bool BLI_mmap_prefetch(BLI_mmap_file *file, size_t offset, size_t length)
+{
+  if (file->io_error || (offset + length > file->length)) {
+    return false;
+  }
+  if (length == 0) {
+    return true;
+  }
+
+#ifndef WIN32
+  /* If an error occurs in this call, sigbus_handler will be called and will set
+   * file->io_error to true. */
+  mmap_touch_pages(file->memory + offset, length);
+#else
+  __try
+  {
+    mmap_touch_pages(file->memory + offset, length);
+  }
+  __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER :
+                                                            EXCEPTION_CONTINUE_SEARCH)
+  {
+    file->io_error = true;
+    return false;
+  }
+#endif
+
+  return !file->io_error;
+}
+
 void *BLI_mmap_get_pointer(BLI_mmap_file *file)
 {
   return file->memory;
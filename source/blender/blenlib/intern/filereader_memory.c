@@ -20,6 +20,8 @@ typedef struct {
 
   const char *data;
   BLI_mmap_file *mmap;
+  /** Whether #mmap is freed when closing the reader. */
+  bool owns_mmap;
   size_t length;
 } MemoryReader;
 
@@ -106,21 +108,18 @@ static int64_t memory_read_mmap(FileReader *reader, void *buffer, size_t size)
 static void memory_close_mmap(FileReader *reader)
 {
   MemoryReader *mem = (MemoryReader *)reader;
-  BLI_mmap_free(mem->mmap);
+  if (mem->owns_mmap) {
+    BLI_mmap_free(mem->mmap);
+  }
   MEM_freeN(mem);
 }
 
-FileReader *BLI_filereader_new_mmap(int filedes)
+FileReader *BLI_filereader_new_mmap_file(BLI_mmap_file *mmap_file)
 {
-  BLI_mmap_file *mmap = BLI_mmap_open(filedes);
-  if (mmap == NULL) {
-    return NULL;
-  }
-
   MemoryReader *mem = MEM_callocN(sizeof(MemoryReader), __func__);
 
-  mem->mmap = mmap;
-  mem->length = BLI_mmap_get_length(mmap);
+  mem->mmap = mmap_file;
+  mem->length = BLI_mmap_get_length(mmap_file);
 
   mem->reader.read = memory_read_mmap;
   mem->reader.seek = memory_seek;
@@ -128,3 +127,16 @@ FileReader *BLI_filereader_new_mmap(int filedes)
 
   return (FileReader *)mem;
 }
+
+FileReader *BLI_filereader_new_mmap(int filedes)
+{
+  BLI_mmap_file *mmap = BLI_mmap_open(filedes);
+  if (mmap == NULL) {
+    return NULL;
+  }
+
+  MemoryReader *mem = (MemoryReader *)BLI_filereader_new_mmap_file(mmap);
+  mem->owns_mmap = true;
+
+  return (FileReader *)mem;
+}
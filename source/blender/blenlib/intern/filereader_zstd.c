@@ -11,6 +11,8 @@
 
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #ifdef __BIG_ENDIAN__
 #  include "BLI_endian_switch.h"
@@ -18,7 +20,40 @@
 
 #include "MEM_guardedalloc.h"
 
-typedef struct {
+#include "atomic_ops.h"
+
+/**
+ * Number of frames decompressed ahead of the reader per scheduler thread.
+ * Frames are #ZSTD_CHUNK_SIZE (1mb) of uncompressed data when written by Blender.
+ */
+#define ZSTD_PREFETCH_FRAMES_PER_THREAD 2
+
+/** States of a #ZstdFrameSlot, changed atomically. */
+enum {
+  /** Compressed data is loaded, nobody started decompressing it yet. */
+  ZSTD_SLOT_PENDING = 0,
+  /** A thread (worker or reader) is decompressing the frame. */
+  ZSTD_SLOT_RUNNING = 1,
+  /** Decompression finished, `uncompressed_data` is NULL on failure. */
+  ZSTD_SLOT_DONE = 2,
+};
+
+struct ZstdReader;
+
+/** A frame of the seekable stream that is decompressed ahead of the reader. */
+typedef struct ZstdFrameSlot {
+  struct ZstdReader *zstd;
+  /** Decompression context owned by the slot, so that slots can run in parallel. */
+  ZSTD_DCtx *ctx;
+  /** Frame index, -1 when the slot is unused. */
+  int frame;
+  int32_t state;
+
+  char *compressed_data;
+  char *uncompressed_data;
+} ZstdFrameSlot;
+
+typedef struct ZstdReader {
   FileReader reader;
 
   FileReader *base;
@@ -35,6 +70,23 @@ typedef struct {
     char *cached_content;
     int cached_frame;
   } seek;
+
+  /**
+   * Parallel read-ahead of the seekable stream. Reading the compressed data is done by the
+   * reader thread (the base #FileReader is not thread-safe), decompression happens on the task
+   * scheduler. The reader only waits for the frame it actually needs, and decompresses it itself
+   * if no worker picked it up yet.
+   */
+  struct {
+    TaskPool *pool;
+    ThreadMutex mutex;
+    ThreadCondition cond;
+
+    ZstdFrameSlot *slots;
+    int slots_num;
+    /** Next frame to be scheduled for decompression. */
+    int next_frame;
+  } prefetch;
 } ZstdReader;
 
 static bool zstd_read_u32(FileReader *base, uint32_t *val)
@@ -157,38 +209,248 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+/* Read the compressed data of a frame from the base reader. */
+static char *zstd_read_compressed_frame(ZstdReader *zstd, int frame)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
-  }
-
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
-
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
-  size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
-                             zstd->seek.uncompressed_ofs[frame];
 
-  char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
   char *compressed_data = MEM_mallocN(compressed_size, __func__);
   if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
       zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
   {
     MEM_freeN(compressed_data);
-    MEM_freeN(uncompressed_data);
     return NULL;
   }
+  return compressed_data;
+}
 
+/* Decompress a frame, takes ownership of `compressed_data`. Safe to call from any thread as long
+ * as `ctx` is not used concurrently. */
+static char *zstd_decompress_frame(ZstdReader *zstd,
+                                   ZSTD_DCtx *ctx,
+                                   int frame,
+                                   char *compressed_data)
+{
+  size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
+  size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
+                             zstd->seek.uncompressed_ofs[frame];
+
+  char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
   size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+      ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
   MEM_freeN(compressed_data);
   if (ZSTD_isError(res) || res < uncompressed_size) {
     MEM_freeN(uncompressed_data);
     return NULL;
   }
+  return uncompressed_data;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Parallel Read-Ahead
+ * \{ */
+
+static void zstd_slot_decompress(ZstdFrameSlot *slot)
+{
+  ZstdReader *zstd = slot->zstd;
+  char *uncompressed_data = zstd_decompress_frame(
+      zstd, slot->ctx, slot->frame, slot->compressed_data);
+  slot->compressed_data = NULL;
+
+  BLI_mutex_lock(&zstd->prefetch.mutex);
+  slot->uncompressed_data = uncompressed_data;
+  atomic_cas_int32(&slot->state, ZSTD_SLOT_RUNNING, ZSTD_SLOT_DONE);
+  BLI_condition_notify_all(&zstd->prefetch.cond);
+  BLI_mutex_unlock(&zstd->prefetch.mutex);
+}
+
+static void zstd_prefetch_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  ZstdFrameSlot *slot = (ZstdFrameSlot *)taskdata;
+  /* The reader may have claimed the slot already because it needed the frame before any worker
+   * got to it. In that case there is nothing left to do here. */
+  if (atomic_cas_int32(&slot->state, ZSTD_SLOT_PENDING, ZSTD_SLOT_RUNNING) != ZSTD_SLOT_PENDING) {
+    return;
+  }
+  zstd_slot_decompress(slot);
+}
+
+/* Make sure the slot is finished: decompress it on the calling thread if no worker started it,
+ * otherwise wait for the worker. */
+static void zstd_slot_finish(ZstdReader *zstd, ZstdFrameSlot *slot)
+{
+  if (atomic_cas_int32(&slot->state, ZSTD_SLOT_PENDING, ZSTD_SLOT_RUNNING) == ZSTD_SLOT_PENDING) {
+    zstd_slot_decompress(slot);
+    return;
+  }
+  BLI_mutex_lock(&zstd->prefetch.mutex);
+  while (atomic_load_int32(&slot->state) != ZSTD_SLOT_DONE) {
+    BLI_condition_wait(&zstd->prefetch.cond, &zstd->prefetch.mutex);
+  }
+  BLI_mutex_unlock(&zstd->prefetch.mutex);
+}
+
+/* Take the decompressed data out of the slot and mark it unused. */
+static char *zstd_slot_take(ZstdReader *zstd, ZstdFrameSlot *slot)
+{
+  zstd_slot_finish(zstd, slot);
+  char *uncompressed_data = slot->uncompressed_data;
+  slot->uncompressed_data = NULL;
+  slot->frame = -1;
+  return uncompressed_data;
+}
+
+/* Free the slot content and mark it unused. Frames no worker started on are dropped without
+ * decompressing them, only a frame that is being decompressed already has to be waited for. */
+static void zstd_slot_discard(ZstdReader *zstd, ZstdFrameSlot *slot)
+{
+  if (atomic_cas_int32(&slot->state, ZSTD_SLOT_PENDING, ZSTD_SLOT_DONE) == ZSTD_SLOT_PENDING) {
+    MEM_freeN(slot->compressed_data);
+    slot->compressed_data = NULL;
+    slot->frame = -1;
+    return;
+  }
+
+  char *uncompressed_data = zstd_slot_take(zstd, slot);
+  if (uncompressed_data) {
+    MEM_freeN(uncompressed_data);
+  }
+}
+
+/* Schedule the following frames into all unused slots. */
+static void zstd_prefetch_fill(ZstdReader *zstd)
+{
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    if (zstd->prefetch.next_frame >= zstd->seek.frames_num) {
+      break;
+    }
+    ZstdFrameSlot *slot = &zstd->prefetch.slots[i];
+    if (slot->frame != -1) {
+      continue;
+    }
+    char *compressed_data = zstd_read_compressed_frame(zstd, zstd->prefetch.next_frame);
+    if (compressed_data == NULL) {
+      /* Leave the error to be reported by the synchronous path once the frame is needed. */
+      break;
+    }
+    slot->frame = zstd->prefetch.next_frame++;
+    slot->compressed_data = compressed_data;
+    /* Publish the slot content before the state, a stale task from a previous use of this slot
+     * may pick it up as well, which is fine since only one of them can claim it. */
+    atomic_cas_int32(&slot->state, ZSTD_SLOT_DONE, ZSTD_SLOT_PENDING);
+    BLI_task_pool_push(zstd->prefetch.pool, zstd_prefetch_task, slot, false, NULL);
+  }
+}
+
+/* Get the decompressed frame from the read-ahead, returns false if the frame
+ * is not handled by it (e.g. the reader seeked back to an earlier frame). */
+static bool zstd_prefetch_get(ZstdReader *zstd, int frame, char **r_data)
+{
+  if (frame >= zstd->prefetch.next_frame) {
+    /* The reader jumped ahead of the read-ahead window, restart it at the wanted frame. */
+    for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+      if (zstd->prefetch.slots[i].frame != -1) {
+        zstd_slot_discard(zstd, &zstd->prefetch.slots[i]);
+      }
+    }
+    zstd->prefetch.next_frame = frame;
+    zstd_prefetch_fill(zstd);
+  }
+
+  ZstdFrameSlot *found = NULL;
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    ZstdFrameSlot *slot = &zstd->prefetch.slots[i];
+    if (slot->frame == frame) {
+      found = slot;
+    }
+    else if (slot->frame != -1 && slot->frame < frame) {
+      /* Frames skipped by the reader (e.g. blocks that are read on demand later). */
+      zstd_slot_discard(zstd, slot);
+    }
+  }
+  if (found == NULL) {
+    return false;
+  }
+
+  *r_data = zstd_slot_take(zstd, found);
+  zstd_prefetch_fill(zstd);
+  return true;
+}
+
+static void zstd_prefetch_init(ZstdReader *zstd)
+{
+  const int threads_num = BLI_task_scheduler_num_threads();
+  if (threads_num <= 1 || zstd->seek.frames_num <= 1) {
+    return;
+  }
+
+  zstd->prefetch.slots_num = min_ii(threads_num * ZSTD_PREFETCH_FRAMES_PER_THREAD,
+                                    zstd->seek.frames_num);
+  zstd->prefetch.slots = MEM_calloc_arrayN(
+      zstd->prefetch.slots_num, sizeof(ZstdFrameSlot), __func__);
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    ZstdFrameSlot *slot = &zstd->prefetch.slots[i];
+    slot->zstd = zstd;
+    slot->ctx = ZSTD_createDCtx();
+    slot->frame = -1;
+    slot->state = ZSTD_SLOT_DONE;
+  }
+  zstd->prefetch.next_frame = 0;
+  zstd->prefetch.pool = BLI_task_pool_create(zstd, TASK_PRIORITY_HIGH);
+  BLI_mutex_init(&zstd->prefetch.mutex);
+  BLI_condition_init(&zstd->prefetch.cond);
+}
+
+static void zstd_prefetch_free(ZstdReader *zstd)
+{
+  if (zstd->prefetch.slots == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    if (zstd->prefetch.slots[i].frame != -1) {
+      zstd_slot_discard(zstd, &zstd->prefetch.slots[i]);
+    }
+  }
+  /* Stale tasks may still be queued, they don't touch the slots anymore once claimed,
+   * but they have to be gone before the slots are freed. */
+  BLI_task_pool_work_and_wait(zstd->prefetch.pool);
+  BLI_task_pool_free(zstd->prefetch.pool);
+
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    ZSTD_freeDCtx(zstd->prefetch.slots[i].ctx);
+  }
+  MEM_freeN(zstd->prefetch.slots);
+  BLI_mutex_end(&zstd->prefetch.mutex);
+  BLI_condition_end(&zstd->prefetch.cond);
+  memset(&zstd->prefetch, 0, sizeof(zstd->prefetch));
+}
+
+/** \} */
+
+/* Ensure that the currently loaded frame is the correct one. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  if (zstd->seek.cached_frame == frame) {
+    /* Cached frame matches, so just return it. */
+    return zstd->seek.cached_content;
+  }
+
+  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
+  MEM_SAFE_FREE(zstd->seek.cached_content);
+  zstd->seek.cached_frame = -1;
+
+  char *uncompressed_data = NULL;
+  if (zstd->prefetch.slots == NULL || !zstd_prefetch_get(zstd, frame, &uncompressed_data)) {
+    char *compressed_data = zstd_read_compressed_frame(zstd, frame);
+    if (compressed_data == NULL) {
+      return NULL;
+    }
+    uncompressed_data = zstd_decompress_frame(zstd, zstd->ctx, frame, compressed_data);
+  }
+  if (uncompressed_data == NULL) {
+    return NULL;
+  }
 
   zstd->seek.cached_frame = frame;
   zstd->seek.cached_content = uncompressed_data;
@@ -283,6 +545,7 @@ static void zstd_close(FileReader *reader)
 
   ZSTD_freeDCtx(zstd->ctx);
   if (zstd->reader.seek) {
+    zstd_prefetch_free(zstd);
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
     /* When an error has occurred this may be NULL, see: #99744. */
@@ -308,6 +571,7 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   if (zstd_read_seek_table(zstd)) {
     zstd->reader.read = zstd_read_seekable;
     zstd->reader.seek = zstd_seek;
+    zstd_prefetch_init(zstd);
   }
   else {
     zstd->reader.read = zstd_read;
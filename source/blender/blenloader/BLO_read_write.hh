@@ -369,6 +369,17 @@ const blender::ImplicitSharingInfo *BLO_read_shared(
   return shared_data.sharing_info;
 }
 
+/**
+ * Reference a plain array (without pointers to other data) directly from the memory mapped file
+ * instead of copying it, when possible. Meant to be used in the callback of #BLO_read_shared.
+ *
+ * \return The sharing-info owning the array when it could be referenced from the file, \a ptr_p
+ * is updated in that case. Otherwise null is returned and the array has to be read as usual.
+ */
+const blender::ImplicitSharingInfo *BLO_read_mapped_array(BlendDataReader *reader,
+                                                         void **ptr_p,
+                                                         size_t expected_size);
+
 int BLO_read_fileversion_get(BlendDataReader *reader);
 bool BLO_read_requires_endian_switch(BlendDataReader *reader);
 bool BLO_read_data_is_undo(BlendDataReader *reader);
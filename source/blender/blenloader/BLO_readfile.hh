@@ -88,7 +88,7 @@ struct BlendFileReadWMSetupData {
 };
 
 struct BlendFileReadParams {
-  uint skip_flags : 3; /* #eBLOReadSkip */
+  uint skip_flags : 4; /* #eBLOReadSkip */
   uint is_startup : 1;
   uint is_factory_settings : 1;
 
@@ -107,8 +107,31 @@ struct BlendFileReadReport {
     double lib_overrides;
     double lib_overrides_resync;
     double lib_overrides_recursive_resync;
+
+    /**
+     * Per-phase timings of the main blend-file reading. `libraries` also includes the
+     * `lib_link` phase, and `read_data` includes reading & decompressing the file itself.
+     */
+    double read_data;
+    double versioning;
+    double lib_link;
+    /**
+     * Replacing the current Main by the read one (see #BKE_blendfile_read_setup_readfile), this
+     * includes `lib_overrides_resync`.
+     */
+    double setup;
   } duration;
 
+  /**
+   * Memory information, as the change of allocated memory (in bytes) over the matching phases
+   * of `duration`.
+   */
+  struct {
+    int64_t read_data;
+    int64_t versioning;
+    int64_t lib_link;
+  } memory;
+
   /** Count information. */
   struct {
     /**
@@ -150,8 +173,17 @@ enum eBLOReadSkip {
   BLO_READ_SKIP_DATA = (1 << 1),
   /** Do not attempt to re-use IDs from old bmain for unchanged ones in case of undo. */
   BLO_READ_SKIP_UNDO_OLD_MAIN = (1 << 2),
+  /**
+   * Only read the local data-blocks used by the UI (window-manager, workspaces, screens) and the
+   * active scene, and everything they depend on. Other ID blocks are only indexed, their data is
+   * never read, and linked data-blocks that are not used are not loaded from their libraries.
+   *
+   * Meant for read-only processing like rendering, #Main.is_partially_read is set so that the
+   * result is never written back over the original file.
+   */
+  BLO_READ_SKIP_UNUSED_IDS = (1 << 3),
 };
-ENUM_OPERATORS(eBLOReadSkip, BLO_READ_SKIP_UNDO_OLD_MAIN)
+ENUM_OPERATORS(eBLOReadSkip, BLO_READ_SKIP_UNUSED_IDS)
 #define BLO_READ_SKIP_ALL (BLO_READ_SKIP_USERDEF | BLO_READ_SKIP_DATA)
 
 /**
@@ -12,11 +12,13 @@
 #include "BLI_filereader.h"
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
+#include "BLI_set.hh"
 
 namespace blender {
 class ImplicitSharingInfo;
 }
 struct Main;
+struct MemFileSpill;
 struct Scene;
 
 struct MemFileSharedStorage {
@@ -52,6 +54,8 @@ struct MemFile {
    * without making a copy. This is faster and requires less memory.
    */
   MemFileSharedStorage *shared_storage;
+  /** Chunks that were moved to disk by #BLO_memfile_spill, null when there are none. */
+  MemFileSpill *spill;
 };
 
 struct MemFileWriteData {
@@ -108,6 +112,23 @@ void BLO_memfile_merge(MemFile *first, MemFile *second);
  */
 void BLO_memfile_clear_future(MemFile *memfile);
 
+/**
+ * Compress the chunks owned by \a memfile in a background thread and move them to a temporary
+ * file at \a filepath, freeing their memory. Buffers in \a shared_buffers (used by other
+ * memfiles) are kept in memory.
+ *
+ * The memfile must be loaded back with #BLO_memfile_unspill before reading it or using it as
+ * reference for writing a new memfile.
+ */
+void BLO_memfile_spill(MemFile *memfile,
+                       const blender::Set<const char *> &shared_buffers,
+                       const char *filepath);
+/**
+ * Load the chunks moved to disk by #BLO_memfile_spill back into memory.
+ * \return false when the spilled data could not be read back.
+ */
+bool BLO_memfile_unspill(MemFile *memfile);
+
 /* Utilities. */
 
 Main *BLO_memfile_main_get(MemFile *memfile, Main *bmain, Scene **r_scene);
@@ -42,6 +42,13 @@ struct BlendFileWriteParams {
   /** On write, restore paths after editing them (see #BLO_WRITE_PATH_REMAP_RELATIVE). */
   uint use_save_as_copy : 1;
   uint use_userdef : 1;
+  /**
+   * Zstd compression level used when writing with #G_FILE_COMPRESS,
+   * zero uses the default level (favoring speed).
+   */
+  int compression_level;
+  /** Number of threads used for compression, zero to use all but one of the system threads. */
+  int compression_threads;
   const BlendThumbnail *thumb;
 };
 
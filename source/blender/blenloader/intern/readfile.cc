@@ -6,6 +6,7 @@
  * \ingroup blenloader
  */
 
+#include <algorithm>
 #include <cctype> /* for isdigit. */
 #include <cerrno>
 #include <climits>
@@ -50,21 +51,32 @@
 #include "MEM_alloc_string_storage.hh"
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_blenlib.h"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
 #include "BLI_ghash.h"
+#include "BLI_hash.hh"
+#include "BLI_hash_md5.hh"
 #include "BLI_linklist.h"
 #include "BLI_map.hh"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
+#include "BLI_set.hh"
+#include "BLI_system.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
+#include "BLI_vector.hh"
+#include BLI_SYSTEM_PID_H
 
 #include "BLT_translation.hh"
 
 #include "BKE_anim_data.hh"
 #include "BKE_animsys.h"
+#include "BKE_appdir.hh"
 #include "BKE_asset.hh"
 #include "BKE_blender_version.h"
 #include "BKE_collection.hh"
@@ -183,6 +195,7 @@ static CLG_LogRef LOG_UNDO = {"blo.readfile.undo"};
 
 /* local prototypes */
 static void read_libraries(FileData *basefd, ListBase *mainlist);
+static void read_used_ids_skipped(FileData *fd, BlendFileData *bfd);
 static void *read_struct(FileData *fd, BHead *bh, const char *blockname, const int id_type_index);
 static BHead *find_bhead_from_code_name(FileData *fd, const short idcode, const char *name);
 
@@ -333,6 +346,154 @@ static void oldnewmap_free(OldNewMap *onm)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Memory Mapped Data
+ *
+ * When reading uncompressed files, large arrays can be referenced directly from the memory
+ * mapped file instead of being copied into new allocations. The mapping is private, so modifying
+ * the data only copies the affected pages and never changes the file.
+ *
+ * Only arrays read with #BLO_read_mapped_array are referenced from the mapping, since other code
+ * expects to own a regular allocation, which it can free with #MEM_freeN.
+ * \{ */
+
+/** Smaller data-blocks are always copied, mapping them wouldn't save much. */
+#define MAPPED_DATA_MIN_SIZE (1 << 16)
+
+/** Owns the memory mapping of a file, which is freed once nothing references it anymore. */
+class MappedFileSharingInfo : public blender::ImplicitSharingInfo {
+ private:
+  BLI_mmap_file *mmap_file_;
+
+ public:
+  MappedFileSharingInfo(BLI_mmap_file *mmap_file) : mmap_file_(mmap_file) {}
+
+  BLI_mmap_file *mmap_file() const
+  {
+    return mmap_file_;
+  }
+
+  const char *data() const
+  {
+    return static_cast<const char *>(BLI_mmap_get_pointer(mmap_file_));
+  }
+
+ private:
+  void delete_self_with_data() override
+  {
+    BLI_mmap_free(mmap_file_);
+    MEM_delete(this);
+  }
+};
+
+/** Sharing-info for an array that is referenced from a memory mapped file. */
+class MappedDataSharingInfo : public blender::ImplicitSharingInfo {
+ private:
+  const blender::ImplicitSharingInfo *file_sharing_info_;
+
+ public:
+  MappedDataSharingInfo(const blender::ImplicitSharingInfo *file_sharing_info)
+      : file_sharing_info_(file_sharing_info)
+  {
+    file_sharing_info_->add_user();
+  }
+
+ private:
+  void delete_self_with_data() override
+  {
+    file_sharing_info_->remove_user_and_delete_if_last();
+    MEM_delete(this);
+  }
+};
+
+/**
+ * Referencing the file memory is only used for background processes (e.g. render farm nodes),
+ * interactive sessions may overwrite files they have open, e.g. on auto-save.
+ *
+ * Not used on Windows, where a mapped view blocks overwriting and renaming the file, so it has
+ * to be unmapped once the file is read.
+ */
+static bool mapped_data_use()
+{
+#ifdef WIN32
+  return false;
+#else
+  return G.background;
+#endif
+}
+
+/**
+ * Get the data of \a bh from the memory mapped file without copying it, when possible.
+ * \return null when the data has to be read normally (see #read_struct).
+ */
+static void *read_struct_mapped(FileData *fd, BHead *bh)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (fd->mapped_file_sharing_info == nullptr || bh->len < MAPPED_DATA_MIN_SIZE ||
+      (fd->flags & FD_FLAGS_SWITCH_ENDIAN) || fd->compflags[bh->SDNAnr] != SDNA_CMP_EQUAL)
+  {
+    return nullptr;
+  }
+  const BHeadN *new_bhead = BHEADN_FROM_BHEAD(bh);
+  if (new_bhead->has_data || new_bhead->file_offset == 0) {
+    return nullptr;
+  }
+  const int alignment = max_ii(DNA_struct_alignment(fd->filesdna, bh->SDNAnr), 8);
+  const MappedFileSharingInfo *file_sharing_info = static_cast<const MappedFileSharingInfo *>(
+      fd->mapped_file_sharing_info);
+  void *data = const_cast<char *>(file_sharing_info->data() + new_bhead->file_offset);
+  if (uintptr_t(data) % uintptr_t(alignment) != 0) {
+    return nullptr;
+  }
+  /* Load the data with IO errors handled, in which case reading it normally reports them. */
+  if (!BLI_mmap_prefetch(
+          file_sharing_info->mmap_file(), size_t(new_bhead->file_offset), size_t(bh->len)))
+  {
+    return nullptr;
+  }
+  fd->mapped_data.add(data, {size_t(bh->len), alignment});
+  return data;
+#else
+  UNUSED_VARS(fd, bh);
+  return nullptr;
+#endif
+}
+
+/**
+ * Data-blocks accessed without #BLO_read_mapped_array must be regular allocations owned by the
+ * caller, copy them out of the memory mapped file.
+ */
+static void *mapped_data_ensure_copy(FileData *fd, const void *adr, void *newp)
+{
+  if (newp == nullptr || fd->mapped_data.is_empty()) {
+    return newp;
+  }
+  const std::optional<FileData::MappedData> mapped_data = fd->mapped_data.pop_try(newp);
+  if (!mapped_data) {
+    return newp;
+  }
+  void *data = MEM_mallocN_aligned(mapped_data->size, size_t(mapped_data->alignment), __func__);
+  memcpy(data, newp, mapped_data->size);
+  fd->datamap->map.lookup(adr).newp = data;
+  return data;
+}
+
+/** Clear #FileData.datamap, unused data-blocks in the memory mapped file must not be freed. */
+static void datamap_clear(FileData *fd)
+{
+  if (!fd->mapped_data.is_empty()) {
+    for (NewAddress &new_addr : fd->datamap->map.values()) {
+      if (fd->mapped_data.contains(new_addr.newp)) {
+        new_addr.nr = 1;
+      }
+    }
+    fd->mapped_data.clear();
+  }
+  oldnewmap_clear(fd->datamap);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Helper Functions
  * \{ */
@@ -1209,11 +1370,347 @@ static bool is_minversion_older_than_blender(FileData *fd, ReportList *reports)
   return false;
 }
 
-static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name BHead Index
+ *
+ * Sidecar cache storing the list of all #BHead of a blend-file, so that libraries do not have to
+ * be scanned completely (and decompressed) every time data is linked from them.
+ *
+ * Only the content of non-#BLO_CODE_DATA blocks is stored (ID structs, #FileGlobal, DNA...),
+ * this is all that is needed to find data-blocks by name or address, the actual data is read
+ * on demand from the file when an ID is read (see #USE_BHEAD_READ_ON_DEMAND).
+ *
+ * Indices are stored in `BKE_appdir_folder_caches/blend-file-indices/`, and invalidated when the
+ * identity of the blend-file changes: its size, modification time, inode and a hash of its start
+ * and end. The least recently used indices are removed when the folder grows too large.
+ * \{ */
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+
+/** Bump when the layout of the index file changes. */
+#  define BHEAD_INDEX_VERSION 2
+
+/** Size of the start and of the end of the blend-file that are hashed into the index header. */
+#  define BHEAD_INDEX_HASH_CHUNK_SIZE (64 * 1024)
+
+/** Total size of all indices above which the least recently used ones are removed. */
+#  define BHEAD_INDEX_FOLDER_SIZE_MAX (int64_t(1024) * 1024 * 1024)
+
+struct BHeadIndexHeader {
+  char magic[8];
+  int version;
+  /** Only the flags that affect how #BHead are decoded, see #BHEAD_INDEX_FILE_FLAGS. */
+  int fd_flags;
+  int fileversion;
+  int sizeof_bhead;
+  int64_t file_size;
+  /** In nanoseconds, as far as the file system supports it. */
+  int64_t file_mtime;
+  /** Zero on file systems without inodes. */
+  uint64_t file_inode;
+  /** MD5 of the start and end of the file, for file systems with coarse modification times. */
+  uint8_t file_hash[16];
+  int64_t bheads_num;
+};
+
+#  define BHEAD_INDEX_FILE_FLAGS \
+    (FD_FLAGS_SWITCH_ENDIAN | FD_FLAGS_FILE_POINTSIZE_IS_4 | FD_FLAGS_POINTSIZE_DIFFERS)
+
+static const char bhead_index_magic[8] = {'B', 'L', 'B', 'H', 'I', 'D', 'X', '\0'};
+
+struct BHeadIndexEntry {
+  BHead bhead;
+  int64_t file_offset;
+  /** The block content follows the entry when true. */
+  int64_t has_data;
+};
+
+static bool bhead_index_use(const FileData *fd)
+{
+  if (!USER_EXPERIMENTAL_TEST(&U, use_blend_file_index)) {
+    return false;
+  }
+  /* Data of #BLO_CODE_DATA blocks is read on demand, which requires seeking. */
+  return (fd->flags & FD_FLAGS_IS_MEMFILE) == 0 && fd->file->seek != nullptr &&
+         fd->relabase[0] != '\0';
+}
+
+static bool bhead_index_folder(char *r_dirpath, const size_t dirpath_maxncpy)
+{
+  if (!BKE_appdir_folder_caches(r_dirpath, dirpath_maxncpy)) {
+    return false;
+  }
+  BLI_path_append(r_dirpath, dirpath_maxncpy, "blend-file-indices");
+  return true;
+}
+
+static std::string bhead_index_filepath(const char *blend_filepath)
+{
+  char index_path[FILE_MAX];
+  if (!bhead_index_folder(index_path, sizeof(index_path))) {
+    return "";
+  }
+
+  const uint64_t path_hash = blender::get_default_hash(blender::StringRef(blend_filepath));
+  const std::string filename = fmt::format(
+      "{:016x}_{}.bhead-index", path_hash, BLI_path_basename(blend_filepath));
+  BLI_path_append(index_path, sizeof(index_path), filename.c_str());
+  return index_path;
+}
+
+static int64_t bhead_index_mtime_ns(const BLI_stat_t &st)
+{
+#  if defined(WIN32)
+  return int64_t(st.st_mtime) * 1000000000;
+#  elif defined(__APPLE__)
+  return int64_t(st.st_mtimespec.tv_sec) * 1000000000 + int64_t(st.st_mtimespec.tv_nsec);
+#  else
+  return int64_t(st.st_mtim.tv_sec) * 1000000000 + int64_t(st.st_mtim.tv_nsec);
+#  endif
+}
+
+/**
+ * Hash the start and the end of the file. Files re-saved within the modification time
+ * resolution of the file system are unlikely to match there, as the end holds the DNA and the
+ * start the file globals and the first data-blocks.
+ */
+static bool bhead_index_file_hash(const char *filepath,
+                                  const int64_t file_size,
+                                  uint8_t r_hash[16])
+{
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return false;
+  }
+  const int64_t chunk_size = std::min(file_size, int64_t(BHEAD_INDEX_HASH_CHUNK_SIZE));
+  blender::Array<char> buffer(chunk_size * 2);
+  bool success = BLI_read(file, buffer.data(), size_t(chunk_size)) == chunk_size;
+  if (success) {
+    success = BLI_lseek(file, file_size - chunk_size, SEEK_SET) == file_size - chunk_size &&
+              BLI_read(file, buffer.data() + chunk_size, size_t(chunk_size)) == chunk_size;
+  }
+  close(file);
+
+  if (success) {
+    BLI_hash_md5_buffer(buffer.data(), size_t(buffer.size()), r_hash);
+  }
+  return success;
+}
+
+static bool bhead_index_header_init(const FileData *fd, BHeadIndexHeader *r_header)
+{
+  BLI_stat_t st;
+  if (BLI_stat(fd->relabase, &st) == -1) {
+    return false;
+  }
+  memset(r_header, 0, sizeof(*r_header));
+  memcpy(r_header->magic, bhead_index_magic, sizeof(r_header->magic));
+  r_header->version = BHEAD_INDEX_VERSION;
+  r_header->fd_flags = fd->flags & BHEAD_INDEX_FILE_FLAGS;
+  r_header->fileversion = fd->fileversion;
+  r_header->sizeof_bhead = sizeof(BHead);
+  r_header->file_size = int64_t(st.st_size);
+  r_header->file_mtime = bhead_index_mtime_ns(st);
+#  ifndef WIN32
+  r_header->file_inode = uint64_t(st.st_ino);
+#  endif
+  return bhead_index_file_hash(fd->relabase, r_header->file_size, r_header->file_hash);
+}
+
+/**
+ * Remove the least recently used indices while their total size is above
+ * #BHEAD_INDEX_FOLDER_SIZE_MAX. Indices of moved or deleted blend-files are never read again,
+ * so they are the first to go.
+ */
+static void bhead_index_folder_prune()
+{
+  char dirpath[FILE_MAX];
+  if (!bhead_index_folder(dirpath, sizeof(dirpath))) {
+    return;
+  }
+  direntry *filelist;
+  const uint filelist_num = BLI_filelist_dir_contents(dirpath, &filelist);
+
+  blender::Vector<const direntry *> indices;
+  int64_t size_total = 0;
+  for (uint i = 0; i < filelist_num; i++) {
+    const direntry *entry = &filelist[i];
+    if (!S_ISDIR(entry->s.st_mode) && BLI_path_extension_check(entry->path, ".bhead-index")) {
+      indices.append(entry);
+      size_total += int64_t(entry->s.st_size);
+    }
+  }
+
+  if (size_total > BHEAD_INDEX_FOLDER_SIZE_MAX) {
+    std::sort(indices.begin(), indices.end(), [](const direntry *a, const direntry *b) {
+      return a->s.st_mtime < b->s.st_mtime;
+    });
+    for (const direntry *entry : indices) {
+      if (size_total <= BHEAD_INDEX_FOLDER_SIZE_MAX) {
+        break;
+      }
+      if (BLI_delete(entry->path, false, false) == 0) {
+        size_total -= int64_t(entry->s.st_size);
+      }
+    }
+  }
+
+  BLI_filelist_free(filelist, filelist_num);
+}
+
+/**
+ * Fill #FileData.bhead_list from the index of the file, if there is a valid one.
+ * Must be called right after reading the blend-file header.
+ *
+ * \param expected_header: Describes the blend-file, as initialized by #bhead_index_header_init.
+ */
+static bool bhead_index_read(FileData *fd, BHeadIndexHeader expected_header)
+{
+  BLI_assert(BLI_listbase_is_empty(&fd->bhead_list));
+
+  const std::string index_filepath = bhead_index_filepath(fd->relabase);
+  if (index_filepath.empty()) {
+    return false;
+  }
+  FILE *index_file = BLI_fopen(index_filepath.c_str(), "rb");
+  if (index_file == nullptr) {
+    return false;
+  }
+
+  BHeadIndexHeader header;
+  bool success = fread(&header, sizeof(header), 1, index_file) == 1;
+  if (success) {
+    expected_header.bheads_num = header.bheads_num;
+    success = memcmp(&header, &expected_header, sizeof(header)) == 0;
+  }
+
+  for (int64_t i = 0; success && i < header.bheads_num; i++) {
+    BHeadIndexEntry entry;
+    if (fread(&entry, sizeof(entry), 1, index_file) != 1 || entry.bhead.len < 0 ||
+        entry.has_data != !BHEAD_USE_READ_ON_DEMAND(&entry.bhead))
+    {
+      success = false;
+      break;
+    }
+    const size_t data_len = entry.has_data ? size_t(entry.bhead.len) : 0;
+    BHeadN *new_bhead = static_cast<BHeadN *>(MEM_mallocN(sizeof(BHeadN) + data_len, __func__));
+    new_bhead->next = new_bhead->prev = nullptr;
+    new_bhead->file_offset = entry.has_data ? 0 : off64_t(entry.file_offset);
+    new_bhead->has_data = entry.has_data;
+    new_bhead->is_memchunk_identical = false;
+    new_bhead->bhead = entry.bhead;
+    BLI_addtail(&fd->bhead_list, new_bhead);
+    if (data_len != 0 && fread(new_bhead + 1, data_len, 1, index_file) != 1) {
+      success = false;
+    }
+  }
+  fclose(index_file);
+
+  if (!success) {
+    BLI_freelistN(&fd->bhead_list);
+    return false;
+  }
+
+  /* The list is complete, the file itself is only accessed again to read data on demand. */
+  fd->is_eof = true;
+  /* The modification time of indices tracks their use, see #bhead_index_folder_prune. */
+  BLI_file_touch(index_filepath.c_str());
+  CLOG_INFO(&LOG, 2, "Read BHead index of '%s' (%s)", fd->relabase, index_filepath.c_str());
+  return true;
+}
+
+/**
+ * Write the index of the file, reading all remaining #BHead first.
+ *
+ * \param header: Describes the blend-file as it was before reading it. Nothing is written when
+ * the file changed since then, as the blocks read may then belong to either version.
+ */
+static void bhead_index_write(FileData *fd, BHeadIndexHeader header)
+{
+  for (BHead *bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+    const BHeadN *bheadn = BHEADN_FROM_BHEAD(bhead);
+    if (bheadn->has_data == BHEAD_USE_READ_ON_DEMAND(bhead)) {
+      /* Data was read directly, there is no offset to read it from on demand. */
+      return;
+    }
+    header.bheads_num++;
+  }
+
+  BHeadIndexHeader current_header;
+  if (!bhead_index_header_init(fd, &current_header)) {
+    return;
+  }
+  current_header.bheads_num = header.bheads_num;
+  if (memcmp(&header, &current_header, sizeof(header)) != 0) {
+    return;
+  }
+
+  const std::string index_filepath = bhead_index_filepath(fd->relabase);
+  if (index_filepath.empty() || !BLI_file_ensure_parent_dir_exists(index_filepath.c_str())) {
+    return;
+  }
+  /* Write to a temporary file first, so that concurrent readers never see a partial index. */
+  const std::string index_filepath_temp = index_filepath + fmt::format(".{}.tmp", abs(getpid()));
+  FILE *index_file = BLI_fopen(index_filepath_temp.c_str(), "wb");
+  if (index_file == nullptr) {
+    return;
+  }
+
+  bool success = fwrite(&header, sizeof(header), 1, index_file) == 1;
+  LISTBASE_FOREACH (const BHeadN *, bheadn, &fd->bhead_list) {
+    if (!success) {
+      break;
+    }
+    BHeadIndexEntry entry{};
+    entry.bhead = bheadn->bhead;
+    entry.file_offset = int64_t(bheadn->file_offset);
+    entry.has_data = bheadn->has_data;
+    success = fwrite(&entry, sizeof(entry), 1, index_file) == 1;
+    if (success && bheadn->has_data && bheadn->bhead.len > 0) {
+      success = fwrite(bheadn + 1, size_t(bheadn->bhead.len), 1, index_file) == 1;
+    }
+  }
+  success = (fclose(index_file) == 0) && success;
+
+  if (!success || BLI_rename_overwrite(index_filepath_temp.c_str(), index_filepath.c_str()) != 0)
+  {
+    BLI_delete(index_filepath_temp.c_str(), false, false);
+    return;
+  }
+  CLOG_INFO(&LOG, 2, "Wrote BHead index of '%s' (%s)", fd->relabase, index_filepath.c_str());
+
+  bhead_index_folder_prune();
+}
+
+#endif /* USE_BHEAD_READ_ON_DEMAND */
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name File Data API (Opening)
+ * \{ */
+
+/**
+ * \param use_bhead_index: Use (and create when missing) the sidecar index of all #BHead,
+ * see #bhead_index_read.
+ */
+static FileData *blo_decode_and_check(FileData *fd,
+                                      ReportList *reports,
+                                      const bool use_bhead_index = false)
 {
   read_blender_header(fd);
 
   if (fd->flags & FD_FLAGS_FILE_OK) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    BHeadIndexHeader bhead_index_header;
+    const bool do_bhead_index = use_bhead_index && bhead_index_use(fd) &&
+                                bhead_index_header_init(fd, &bhead_index_header);
+    const bool has_bhead_index = do_bhead_index && bhead_index_read(fd, bhead_index_header);
+#else
+    UNUSED_VARS(use_bhead_index);
+#endif
     const char *error_message = nullptr;
     if (read_file_dna(fd, &error_message) == false) {
       BKE_reportf(
@@ -1225,6 +1722,11 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
       blo_filedata_free(fd);
       fd = nullptr;
     }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    else if (do_bhead_index && !has_bhead_index) {
+      bhead_index_write(fd, bhead_index_header);
+    }
+#endif
   }
   else if (fd->flags & FD_FLAGS_FILE_FUTURE) {
     BKE_reportf(
@@ -1272,10 +1774,20 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
   /* Rewind the file after reading the header. */
   rawfile->seek(rawfile, 0, SEEK_SET);
 
+  const blender::ImplicitSharingInfo *mapped_file_sharing_info = nullptr;
+
   /* Check if we have a regular file. */
   if (memcmp(header, "BLENDER", sizeof(header)) == 0) {
     /* Try opening the file with memory-mapped IO. */
-    file = BLI_filereader_new_mmap(filedes);
+    if (mapped_data_use()) {
+      if (BLI_mmap_file *mmap_file = BLI_mmap_open_copy_on_write(filedes)) {
+        mapped_file_sharing_info = MEM_new<MappedFileSharingInfo>(__func__, mmap_file);
+        file = BLI_filereader_new_mmap_file(mmap_file);
+      }
+    }
+    else {
+      file = BLI_filereader_new_mmap(filedes);
+    }
     if (file == nullptr) {
       /* `mmap` failed, so just keep using `rawfile`. */
       file = rawfile;
@@ -1306,6 +1818,7 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   FileData *fd = filedata_new(reports);
   fd->file = file;
+  fd->mapped_file_sharing_info = mapped_file_sharing_info;
 
   return fd;
 }
@@ -1337,6 +1850,17 @@ FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *repo
   return nullptr;
 }
 
+FileData *blo_filedata_from_library_file(const char *filepath, BlendFileReadReport *reports)
+{
+  FileData *fd = blo_filedata_from_file_open(filepath, reports);
+  if (fd != nullptr) {
+    STRNCPY(fd->relabase, filepath);
+
+    return blo_decode_and_check(fd, reports->reports, true);
+  }
+  return nullptr;
+}
+
 /**
  * Same as blo_filedata_from_file(), but does not reads DNA data, only header.
  * Use it for light access (e.g. thumbnail reading).
@@ -1421,6 +1945,10 @@ void blo_filedata_free(FileData *fd)
   }
 #endif
   fd->file->close(fd->file);
+  if (fd->mapped_file_sharing_info) {
+    /* The mapping stays alive as long as data-blocks reference it. */
+    fd->mapped_file_sharing_info->remove_user_and_delete_if_last();
+  }
 
   if (fd->filesdna) {
     DNA_sdna_free(fd->filesdna);
@@ -1511,16 +2039,18 @@ short BLO_version_from_file(const char *filepath)
 /** \name Old/New Pointer Map
  * \{ */
 
+static void *mapped_data_ensure_copy(FileData *fd, const void *adr, void *newp);
+
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  return mapped_data_ensure_copy(fd, adr, oldnewmap_lookup_and_inc(fd->datamap, adr, true));
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  return mapped_data_ensure_copy(fd, adr, oldnewmap_lookup_and_inc(fd->datamap, adr, false));
 }
 
 void *blo_read_get_new_globaldata_address(FileData *fd, const void *adr)
@@ -2535,7 +3065,10 @@ static BHead *read_data_into_datamap(FileData *fd,
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == BLO_CODE_DATA) {
-    void *data = read_struct(fd, bhead, allocname, id_type_index);
+    void *data = read_struct_mapped(fd, bhead);
+    if (data == nullptr) {
+      data = read_struct(fd, bhead, allocname, id_type_index);
+    }
     if (data) {
       const bool is_new = oldnewmap_insert(fd->datamap, bhead->old, data, 0);
       if (!is_new) {
@@ -3026,7 +3559,7 @@ static BHead *read_libblock(FileData *fd,
    * Use convenient malloc name for debugging and better memory link prints. */
   bhead = read_data_into_datamap(fd, bhead, blockname, id_type_index);
   const bool success = direct_link_id(fd, main, id_tag, id, id_old);
-  oldnewmap_clear(fd->datamap);
+  datamap_clear(fd);
 
   if (!success) {
     /* XXX This is probably working OK currently given the very limited scope of that flag.
@@ -3070,7 +3603,7 @@ BHead *blo_read_asset_data_block(FileData *fd, BHead *bhead, AssetMetaData **r_a
   BLO_read_struct(&reader, AssetMetaData, r_asset_data);
   BKE_asset_metadata_read(&reader, *r_asset_data);
 
-  oldnewmap_clear(fd->datamap);
+  datamap_clear(fd);
 
   return bhead;
 }
@@ -3508,7 +4041,7 @@ static BHead *read_userdef(BlendFileData *bfd, FileData *fd, BHead *bhead)
   user->edit_studio_light = 0;
 
   /* free fd->datamap again */
-  oldnewmap_clear(fd->datamap);
+  datamap_clear(fd);
 
   return bhead;
 }
@@ -3579,6 +4112,21 @@ static void blo_read_file_checks(Main *bmain)
   UNUSED_VARS_NDEBUG(bmain);
 }
 
+/**
+ * Measures the time spent and the memory allocated during one phase of the file reading, and
+ * accumulates them into the matching members of #BlendFileReadReport.
+ */
+struct ReadPhaseTimer {
+  double time_start = BLI_time_now_seconds();
+  size_t memory_start = MEM_get_memory_in_use();
+
+  void end(double &r_duration, int64_t &r_memory) const
+  {
+    r_duration += BLI_time_now_seconds() - time_start;
+    r_memory += int64_t(MEM_get_memory_in_use()) - int64_t(memory_start);
+  }
+};
+
 BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 {
   BHead *bhead = blo_bhead_first(fd);
@@ -3643,6 +4191,12 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     read_undo_reuse_noundo_local_ids(fd);
   }
 
+  /* Only index the local data-blocks here, and read the used ones once the whole file is known,
+   * see #read_used_ids_skipped. */
+  const bool use_skip_unused_ids = !is_undo && (fd->skip_flags & BLO_READ_SKIP_DATA) == 0 &&
+                                   (fd->skip_flags & BLO_READ_SKIP_UNUSED_IDS) != 0;
+
+  const ReadPhaseTimer read_data_timer;
   while (bhead) {
     switch (bhead->code) {
       case BLO_CODE_DATA:
@@ -3667,7 +4221,7 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
         break;
 
       case ID_LINK_PLACEHOLDER:
-        if (fd->skip_flags & BLO_READ_SKIP_DATA) {
+        if ((fd->skip_flags & BLO_READ_SKIP_DATA) || use_skip_unused_ids) {
           bhead = blo_bhead_next(fd, bhead);
         }
         else {
@@ -3691,6 +4245,17 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
           if (fd->skip_flags & BLO_READ_SKIP_DATA) {
             bhead = blo_bhead_next(fd, bhead);
           }
+          else if (use_skip_unused_ids) {
+            /* Libraries are always needed to read the used linked data, UI data-blocks are the
+             * roots (together with the active scene) of the used data-blocks. */
+            if (ELEM(bhead->code, ID_LI, ID_WM, ID_WS, ID_SCR)) {
+              bhead = read_libblock(
+                  fd, bfd->main, bhead, ID_TAG_LOCAL | ID_TAG_NEED_EXPAND, false, nullptr);
+            }
+            else {
+              bhead = blo_bhead_next(fd, bhead);
+            }
+          }
           else {
             bhead = read_libblock(fd, bfd->main, bhead, ID_TAG_LOCAL, false, nullptr);
           }
@@ -3707,6 +4272,15 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+  if (use_skip_unused_ids) {
+    read_used_ids_skipped(fd, bfd);
+    if (bfd->main->is_read_invalid) {
+      return bfd;
+    }
+  }
+
+  read_data_timer.end(fd->reports->duration.read_data, fd->reports->memory.read_data);
+
   if (is_undo) {
     /* Move the remaining Library IDs and their linked data to the new main.
      *
@@ -3732,6 +4306,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 
   /* Do versioning before read_libraries, but skip in undo case. */
   if (!is_undo) {
+    const ReadPhaseTimer versioning_timer;
+
     if ((fd->skip_flags & BLO_READ_SKIP_DATA) == 0) {
       do_versions(fd, nullptr, bfd->main);
     }
@@ -3739,6 +4315,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     if ((fd->skip_flags & BLO_READ_SKIP_USERDEF) == 0) {
       do_versions_userdef(fd, bfd);
     }
+
+    versioning_timer.end(fd->reports->duration.versioning, fd->reports->memory.versioning);
   }
 
   if (bfd->main->is_read_invalid) {
@@ -3751,8 +4329,10 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 
     blo_join_main(&mainlist);
 
+    const ReadPhaseTimer lib_link_timer;
     lib_link_all(fd, bfd->main);
     after_liblink_merged_bmain_process(bfd->main, fd->reports);
+    lib_link_timer.end(fd->reports->duration.lib_link, fd->reports->memory.lib_link);
 
     if (is_undo) {
       /* Ensure ID usages of reused 'no undo' IDs remain valid. */
@@ -3777,6 +4357,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
       /* Necessary to allow 2.80 layer collections conversion code to work. */
       BKE_layer_collection_resync_allow();
 
+      const ReadPhaseTimer versioning_timer;
+
       /* Yep, second splitting... but this is a very cheap operation, so no big deal. */
       blo_split_main(&mainlist, bfd->main);
       LISTBASE_FOREACH (Main *, mainvar, &mainlist) {
@@ -3792,6 +4374,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
       }
       blo_join_main(&mainlist);
 
+      versioning_timer.end(fd->reports->duration.versioning, fd->reports->memory.versioning);
+
       BKE_layer_collection_resync_forbid();
 
       /* And we have to compute those user-reference-counts again, as `do_versions_after_linking()`
@@ -4195,6 +4779,93 @@ static void expand_doit_library(void *fdhandle, Main *mainvar, void *old)
   }
 }
 
+/**
+ * Expand callback for #BLO_READ_SKIP_UNUSED_IDS, reads the local data-blocks and the link
+ * placeholders that were skipped by #blo_read_file_internal, as soon as a used data-block refers
+ * to them.
+ */
+static void expand_doit_used_ids_skipped(void *fdhandle, Main *mainvar, void *old)
+{
+  FileData *fd = static_cast<FileData *>(fdhandle);
+
+  if (mainvar->is_read_invalid) {
+    return;
+  }
+
+  BHead *bhead = find_bhead(fd, old);
+  if (bhead == nullptr) {
+    return;
+  }
+  /* In 2.50+ file identifier for screens is patched, forward compatibility. */
+  if (bhead->code == ID_SCRN) {
+    bhead->code = ID_SCR;
+  }
+  /* Libraries have all been read already. */
+  if (!blo_bhead_is_id_valid_type(bhead) || bhead->code == ID_LI) {
+    return;
+  }
+
+  if (bhead->code == ID_LINK_PLACEHOLDER) {
+    /* Same as in #blo_read_file_internal, the placeholder belongs to the main of the last library
+     * block written before it. */
+    BHead *bheadlib = find_previous_lib(fd, bhead);
+    if (bheadlib == nullptr) {
+      return;
+    }
+    Library *lib = static_cast<Library *>(
+        read_struct(fd, bheadlib, "Data for Library ID type", INDEX_ID_NULL));
+    Main *libmain = blo_find_main(fd, lib->filepath, fd->relabase);
+    MEM_freeN(lib);
+
+    if (libmain->curlib != nullptr && library_id_is_yet_read(fd, libmain, bhead) == nullptr) {
+      read_libblock(fd, libmain, bhead, 0, true, nullptr);
+    }
+    return;
+  }
+
+  if (library_id_is_yet_read(fd, mainvar, bhead) == nullptr) {
+    ID *id = nullptr;
+    read_libblock(fd, mainvar, bhead, ID_TAG_LOCAL | ID_TAG_NEED_EXPAND, false, &id);
+    if (id != nullptr) {
+      id_sort_by_name(which_libbase(mainvar, GS(id->name)), id, static_cast<ID *>(id->prev));
+    }
+  }
+}
+
+/**
+ * Read the data-blocks used by the ones read in #blo_read_file_internal when using
+ * #BLO_READ_SKIP_UNUSED_IDS. All BHeads of the file are known (and indexed by their old address)
+ * at this point, the data of the skipped blocks was never read when the file supports seeking.
+ */
+static void read_used_ids_skipped(FileData *fd, BlendFileData *bfd)
+{
+  Main *bmain = bfd->main;
+
+  /* The active scene is the only root which is not referenced by the UI when reading without it
+   * (e.g. in background mode). Fall back to the first scene like #link_global does. */
+  BHead *bhead_scene = find_bhead(fd, bfd->curscene);
+  if (bhead_scene == nullptr || bhead_scene->code != ID_SCE) {
+    for (bhead_scene = blo_bhead_first(fd); bhead_scene;
+         bhead_scene = blo_bhead_next(fd, bhead_scene))
+    {
+      if (bhead_scene->code == ID_SCE) {
+        break;
+      }
+    }
+  }
+  if (bhead_scene != nullptr && library_id_is_yet_read(fd, bmain, bhead_scene) == nullptr) {
+    read_libblock(fd, bmain, bhead_scene, ID_TAG_LOCAL | ID_TAG_NEED_EXPAND, false, nullptr);
+  }
+
+  BLO_expand_main(fd, bmain, expand_doit_used_ids_skipped);
+
+  if (bmain->id_map != nullptr) {
+    BKE_main_idmap_destroy(bmain->id_map);
+    bmain->id_map = nullptr;
+  }
+  bmain->is_partially_read = true;
+}
+
 static int expand_cb(LibraryIDLinkCallbackData *cb_data)
 {
   /* Embedded IDs are not known by lib_link code, so they would be remapped to `nullptr`. But there
@@ -4729,43 +5400,49 @@ static void read_library_clear_weak_links(FileData *basefd, ListBase *mainlist,
   }
 }
 
-static FileData *read_library_file_data(FileData *basefd,
-                                        ListBase *mainlist,
-                                        Main *mainl,
-                                        Main *mainptr)
+static void read_library_file_report(FileData *basefd, Main *mainptr)
 {
-  FileData *fd = mainptr->curlib->runtime.filedata;
-
-  if (fd != nullptr) {
-    /* File already open. */
-    return fd;
-  }
-
   if (mainptr->curlib->packedfile) {
-    /* Read packed file. */
-    const PackedFile *pf = mainptr->curlib->packedfile;
-
     BLO_reportf_wrap(basefd->reports,
                      RPT_INFO,
                      RPT_("Read packed library: '%s', parent '%s'"),
                      mainptr->curlib->filepath,
                      library_parent_filepath(mainptr->curlib));
-    fd = blo_filedata_from_memory(pf->data, pf->size, basefd->reports);
-
-    /* Needed for library_append and read_libraries. */
-    STRNCPY(fd->relabase, mainptr->curlib->runtime.filepath_abs);
   }
   else {
-    /* Read file on disk. */
     BLO_reportf_wrap(basefd->reports,
                      RPT_INFO,
                      RPT_("Read library: '%s', '%s', parent '%s'"),
                      mainptr->curlib->runtime.filepath_abs,
                      mainptr->curlib->filepath,
                      library_parent_filepath(mainptr->curlib));
-    fd = blo_filedata_from_file(mainptr->curlib->runtime.filepath_abs, basefd->reports);
   }
+}
+
+/**
+ * Open the file of a library. This does not modify any data shared between libraries, so it can
+ * be called for several libraries in parallel, see #read_library_files_open_parallel.
+ */
+static FileData *read_library_file_open(FileData *basefd, Main *mainptr)
+{
+  if (mainptr->curlib->packedfile) {
+    /* Read packed file. */
+    const PackedFile *pf = mainptr->curlib->packedfile;
+    FileData *fd = blo_filedata_from_memory(pf->data, pf->size, basefd->reports);
+    if (fd) {
+      /* Needed for library_append and read_libraries. */
+      STRNCPY(fd->relabase, mainptr->curlib->runtime.filepath_abs);
+    }
+    return fd;
+  }
+  /* Read file on disk. */
+  return blo_filedata_from_library_file(mainptr->curlib->runtime.filepath_abs, basefd->reports);
+}
 
+/** Register the newly opened (or missing) file of a library in the reading process. */
+static FileData *read_library_file_init(
+    FileData *basefd, ListBase *mainlist, Main *mainl, Main *mainptr, FileData *fd)
+{
   if (fd) {
     /* Share the mainlist, so all libraries are added immediately in a
      * single list. It used to be that all FileData's had their own list,
@@ -4809,6 +5486,70 @@ static FileData *read_library_file_data(FileData *basefd,
   return fd;
 }
 
+static FileData *read_library_file_data(FileData *basefd,
+                                        ListBase *mainlist,
+                                        Main *mainl,
+                                        Main *mainptr)
+{
+  FileData *fd = mainptr->curlib->runtime.filedata;
+
+  if (fd != nullptr) {
+    /* File already open. */
+    return fd;
+  }
+
+  read_library_file_report(basefd, mainptr);
+  fd = read_library_file_open(basefd, mainptr);
+  return read_library_file_init(basefd, mainlist, mainl, mainptr, fd);
+}
+
+/**
+ * Open the files of all libraries that have linked data-blocks to read and are not open yet, at
+ * once. Reading the header, DNA and block headers of a file is mostly waiting on I/O (a long
+ * chain of small reads and seeks, especially on network storage), so doing it for independent
+ * libraries in parallel is much faster than opening them one after the other.
+ *
+ * Reading the linked data-blocks themselves is still done one library at a time afterwards, since
+ * it modifies data shared by all libraries (the `mainlist` and the `libmap` of all files).
+ *
+ * \return The libraries whose file was opened (or attempted to), so that it is not tried again.
+ */
+static blender::Set<Main *> read_library_files_open_parallel(FileData *basefd,
+                                                             ListBase *mainlist,
+                                                             Main *mainl)
+{
+  blender::Vector<Main *> mains_to_open;
+  for (Main *mainptr = mainl->next; mainptr; mainptr = mainptr->next) {
+    if (mainptr->curlib->runtime.filedata == nullptr && mainptr->curlib->packedfile == nullptr &&
+        has_linked_ids_to_read(mainptr))
+    {
+      mains_to_open.append(mainptr);
+    }
+  }
+  if (mains_to_open.size() < 2) {
+    return {};
+  }
+
+  for (Main *mainptr : mains_to_open) {
+    read_library_file_report(basefd, mainptr);
+  }
+
+  blender::Array<FileData *> fds(mains_to_open.size());
+  blender::threading::parallel_for(
+      mains_to_open.index_range(), 1, [&](const blender::IndexRange range) {
+        for (const int i : range) {
+          fds[i] = read_library_file_open(basefd, mains_to_open[i]);
+        }
+      });
+
+  for (const int i : mains_to_open.index_range()) {
+    read_library_file_init(basefd, mainlist, mainl, mains_to_open[i], fds[i]);
+  }
+
+  CLOG_INFO(&LOG, 2, "Opened %d library files in parallel", int(mains_to_open.size()));
+  return blender::Set<Main *>(mains_to_open.as_span());
+}
+
 static void read_libraries(FileData *basefd, ListBase *mainlist)
 {
   Main *mainl = static_cast<Main *>(mainlist->first);
@@ -4824,6 +5565,11 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
   while (do_it) {
     do_it = false;
 
+    /* Open all files of the libraries known so far at once, instead of one at a time in the loop
+     * below. */
+    const blender::Set<Main *> mains_opened = read_library_files_open_parallel(
+        basefd, mainlist, mainl);
+
     /* Loop over mains of all library blend files encountered so far. Note
      * this list gets longer as more indirectly library blends are found. */
     for (Main *mainptr = mainl->next; mainptr; mainptr = mainptr->next) {
@@ -4836,7 +5582,9 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
                   mainptr->curlib->filepath);
 
         /* Open file if it has not been done yet. */
-        FileData *fd = read_library_file_data(basefd, mainlist, mainl, mainptr);
+        FileData *fd = mains_opened.contains(mainptr) ?
+                           mainptr->curlib->runtime.filedata :
+                           read_library_file_data(basefd, mainlist, mainl, mainptr);
 
         if (fd) {
           do_it = true;
@@ -5201,6 +5949,28 @@ blender::ImplicitSharingInfoAndData blo_read_shared_impl(
   return shared_data;
 }
 
+const blender::ImplicitSharingInfo *BLO_read_mapped_array(BlendDataReader *reader,
+                                                         void **ptr_p,
+                                                         const size_t expected_size)
+{
+  FileData *fd = reader->fd;
+  if (*ptr_p == nullptr || fd->mapped_data.is_empty()) {
+    return nullptr;
+  }
+  NewAddress *entry = fd->datamap->map.lookup_ptr(*ptr_p);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  const FileData::MappedData *mapped_data = fd->mapped_data.lookup_ptr(entry->newp);
+  if (mapped_data == nullptr || mapped_data->size != expected_size) {
+    return nullptr;
+  }
+  fd->mapped_data.remove(entry->newp);
+  entry->nr++;
+  *ptr_p = entry->newp;
+  return MEM_new<MappedDataSharingInfo>(__func__, fd->mapped_file_sharing_info);
+}
+
 bool BLO_read_data_is_undo(BlendDataReader *reader)
 {
   return (reader->fd->flags & FD_FLAGS_IS_MEMFILE);
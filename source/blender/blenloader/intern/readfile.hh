@@ -16,12 +16,16 @@
 #endif
 
 #include "BLI_filereader.h"
+#include "BLI_map.hh"
 #include "DNA_sdna_types.h"
 #include "DNA_space_types.h"
 #include "DNA_windowmanager_types.h" /* for eReportType */
 
 #include "BLO_readfile.hh"
 
+namespace blender {
+class ImplicitSharingInfo;
+}
 struct BlendFileData;
 struct BlendfileLinkAppendContext;
 struct BlendFileReadParams;
@@ -117,6 +121,22 @@ struct FileData {
   OldNewMap *datamap = nullptr;
   OldNewMap *globmap = nullptr;
 
+  /**
+   * Owns the memory mapped file when large arrays can be referenced directly from the mapped
+   * memory instead of being copied, see #BLO_read_mapped_array. Null otherwise.
+   */
+  const blender::ImplicitSharingInfo *mapped_file_sharing_info = nullptr;
+  /**
+   * Data-blocks in #datamap which still point into the memory mapped file, with their size and
+   * alignment. They are copied into regular allocations when accessed other than through
+   * #BLO_read_mapped_array.
+   */
+  struct MappedData {
+    size_t size;
+    int alignment;
+  };
+  blender::Map<const void *, MappedData> mapped_data;
+
   /**
    * Store mapping from old ID pointers (the values they have in the .blend file) to new ones,
    * typically from value in `bhead->old` to address in memory where the ID was read.
@@ -170,6 +190,12 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath) ATTR_N
  * cannot be called with relative paths anymore!
  */
 FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *reports);
+/**
+ * Same as #blo_filedata_from_file, for library files from which typically only a few data-blocks
+ * are read. Uses the sidecar #BHead index when enabled in the preferences, to avoid scanning the
+ * whole file.
+ */
+FileData *blo_filedata_from_library_file(const char *filepath, BlendFileReadReport *reports);
 FileData *blo_filedata_from_memory(const void *mem, int memsize, BlendFileReadReport *reports);
 FileData *blo_filedata_from_memfile(MemFile *memfile,
                                     const BlendFileReadParams *params,
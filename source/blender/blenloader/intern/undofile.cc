@@ -26,6 +26,8 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_implicit_sharing.hh"
+#include "BLI_task.h"
+#include "BLI_vector.hh"
 
 #include "BLO_readfile.hh"
 #include "BLO_undofile.hh"
@@ -34,14 +36,23 @@
 #include "BKE_main.hh"
 #include "BKE_undo_system.hh"
 
+#include <zstd.h>
+
 #include "BLI_strict_flags.h" /* Keep last. */
 
+/** Fast compression is preferred, spilling should not compete with the user for CPU time. */
+#define MEMFILE_SPILL_COMPRESSION_LEVEL 1
+
 /* **************** support for memory-write, for undo buffers *************** */
 
+static void memfile_spill_free(MemFile *memfile);
+
 void BLO_memfile_free(MemFile *memfile)
 {
+  memfile_spill_free(memfile);
+
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
+    if (chunk->is_identical == false && chunk->buf != nullptr) {
       MEM_freeN((void *)chunk->buf);
     }
     MEM_freeN(chunk);
@@ -59,8 +70,15 @@ MemFileSharedStorage::~MemFileSharedStorage()
   }
 }
 
+static void memfile_spill_wait(MemFile *memfile);
+
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
+  /* Chunks of both memfiles are accessed, the background spilling must be done. Spilled chunks
+   * are never shared, so they don't need to be loaded back. */
+  memfile_spill_wait(first);
+  memfile_spill_wait(second);
+
   /* We use this mapping to store the memory buffers from second memfile chunks which are not owned
    * by it (i.e. shared with some previous memory steps). */
   blender::Map<const char *, MemFileChunk *> buffer_to_second_memchunk;
@@ -167,6 +185,171 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Spilling to Disk
+ *
+ * Memory of undo steps that are far from the active one can be moved to a temporary file.
+ * \{ */
+
+struct MemFileSpillChunk {
+  MemFileChunk *chunk;
+  /** Location of the compressed data in the spill file, #file_size is zero when the chunk could
+   * not be written (in that case it's kept in memory). */
+  int64_t file_offset;
+  size_t file_size;
+};
+
+struct MemFileSpill {
+  char filepath[1024]; /* FILE_MAX */
+  int file_handle;
+  blender::Vector<MemFileSpillChunk> chunks;
+  /** Runs the compression & writing, null once it's finished. */
+  TaskPool *task_pool;
+};
+
+static void memfile_spill_task(TaskPool *__restrict pool, void * /*taskdata*/)
+{
+  MemFileSpill *spill = static_cast<MemFileSpill *>(BLI_task_pool_user_data(pool));
+
+  ZSTD_CCtx *ctx = ZSTD_createCCtx();
+  ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, MEMFILE_SPILL_COMPRESSION_LEVEL);
+
+  int64_t file_offset = 0;
+  char *out_buf = nullptr;
+  size_t out_buf_len = 0;
+  for (MemFileSpillChunk &spill_chunk : spill->chunks) {
+    MemFileChunk *chunk = spill_chunk.chunk;
+    const size_t bound = ZSTD_compressBound(chunk->size);
+    if (out_buf_len < bound) {
+      MEM_SAFE_FREE(out_buf);
+      out_buf = static_cast<char *>(MEM_mallocN(bound, __func__));
+      out_buf_len = bound;
+    }
+    const size_t out_size = ZSTD_compress2(ctx, out_buf, out_buf_len, chunk->buf, chunk->size);
+    if (ZSTD_isError(out_size) ||
+        write(spill->file_handle, out_buf, out_size) != int64_t(out_size))
+    {
+      /* Keep the remaining chunks in memory. */
+      break;
+    }
+    spill_chunk.file_offset = file_offset;
+    spill_chunk.file_size = out_size;
+    file_offset += int64_t(out_size);
+
+    MEM_freeN((void *)chunk->buf);
+    chunk->buf = nullptr;
+  }
+
+  MEM_SAFE_FREE(out_buf);
+  ZSTD_freeCCtx(ctx);
+}
+
+static void memfile_spill_wait(MemFile *memfile)
+{
+  MemFileSpill *spill = memfile->spill;
+  if (spill == nullptr || spill->task_pool == nullptr) {
+    return;
+  }
+  BLI_task_pool_work_and_wait(spill->task_pool);
+  BLI_task_pool_free(spill->task_pool);
+  spill->task_pool = nullptr;
+}
+
+static void memfile_spill_free(MemFile *memfile)
+{
+  if (memfile->spill == nullptr) {
+    return;
+  }
+  memfile_spill_wait(memfile);
+  close(memfile->spill->file_handle);
+  BLI_delete(memfile->spill->filepath, false, false);
+  MEM_delete(memfile->spill);
+  memfile->spill = nullptr;
+}
+
+void BLO_memfile_spill(MemFile *memfile,
+                       const blender::Set<const char *> &shared_buffers,
+                       const char *filepath)
+{
+  if (memfile->spill != nullptr) {
+    return;
+  }
+
+  blender::Vector<MemFileSpillChunk> spill_chunks;
+  size_t spill_size = 0;
+  LISTBASE_FOREACH (MemFileChunk *, chunk, &memfile->chunks) {
+    if (!chunk->is_identical && !shared_buffers.contains(chunk->buf)) {
+      spill_chunks.append({chunk, 0, 0});
+      spill_size += chunk->size;
+    }
+  }
+  if (spill_chunks.is_empty()) {
+    return;
+  }
+
+  const int file_handle = BLI_open(filepath, O_BINARY | O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (file_handle == -1) {
+    return;
+  }
+
+  MemFileSpill *spill = MEM_new<MemFileSpill>(__func__);
+  STRNCPY(spill->filepath, filepath);
+  spill->file_handle = file_handle;
+  spill->chunks = std::move(spill_chunks);
+  spill->task_pool = BLI_task_pool_create_background(spill, TASK_PRIORITY_LOW);
+  BLI_task_pool_push(spill->task_pool, memfile_spill_task, nullptr, false, nullptr);
+
+  memfile->spill = spill;
+  /* Account for the memory as soon as possible, so undo memory limits can use it. Failure to
+   * write is unlikely, the size is corrected when loading back. */
+  memfile->size -= spill_size;
+}
+
+bool BLO_memfile_unspill(MemFile *memfile)
+{
+  MemFileSpill *spill = memfile->spill;
+  if (spill == nullptr) {
+    return true;
+  }
+  memfile_spill_wait(memfile);
+
+  bool ok = true;
+  char *in_buf = nullptr;
+  size_t in_buf_len = 0;
+  for (const MemFileSpillChunk &spill_chunk : spill->chunks) {
+    MemFileChunk *chunk = spill_chunk.chunk;
+    memfile->size += chunk->size;
+    if (chunk->buf != nullptr) {
+      /* Writing this chunk failed, it was kept in memory. */
+      continue;
+    }
+    if (in_buf_len < spill_chunk.file_size) {
+      MEM_SAFE_FREE(in_buf);
+      in_buf = static_cast<char *>(MEM_mallocN(spill_chunk.file_size, __func__));
+      in_buf_len = spill_chunk.file_size;
+    }
+    char *buf = static_cast<char *>(MEM_mallocN(chunk->size, "Chunk buffer"));
+    if (BLI_lseek(spill->file_handle, spill_chunk.file_offset, SEEK_SET) !=
+            spill_chunk.file_offset ||
+        BLI_read(spill->file_handle, in_buf, spill_chunk.file_size) !=
+            int64_t(spill_chunk.file_size) ||
+        ZSTD_decompress(buf, chunk->size, in_buf, spill_chunk.file_size) != chunk->size)
+    {
+      /* Keep the memfile valid (all chunks must have a buffer), even though its contents
+       * are lost. */
+      memset(buf, 0, chunk->size);
+      ok = false;
+    }
+    chunk->buf = buf;
+  }
+  MEM_SAFE_FREE(in_buf);
+
+  memfile_spill_free(memfile);
+  return ok;
+}
+
+/** \} */
+
 Main *BLO_memfile_main_get(MemFile *memfile, Main *bmain, Scene **r_scene)
 {
   Main *bmain_undo = nullptr;
@@ -268,6 +451,7 @@ static void undo_close(FileReader *reader)
 
 FileReader *BLO_memfile_new_filereader(MemFile *memfile, int undo_direction)
 {
+  BLI_assert_msg(memfile->spill == nullptr, "Spilled memfile must be loaded back first");
   UndoReader *undo = static_cast<UndoReader *>(MEM_callocN(sizeof(UndoReader), __func__));
 
   undo->memfile = memfile;
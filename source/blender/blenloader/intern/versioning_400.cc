@@ -1358,9 +1358,9 @@ static void version_vertex_weight_edit_preserve_threshold_exclusivity(Main *bmai
 
 static void version_mesh_crease_generic(Main &bmain)
 {
-  LISTBASE_FOREACH (Mesh *, mesh, &bmain.meshes) {
-    BKE_mesh_legacy_crease_to_generic(mesh);
-  }
+  version_foreach_id_parallel(bmain.meshes, [](ID &id) {
+    BKE_mesh_legacy_crease_to_generic(reinterpret_cast<Mesh *>(&id));
+  });
 
   LISTBASE_FOREACH (bNodeTree *, ntree, &bmain.nodetrees) {
     if (ntree->type == NTREE_GEOMETRY) {
@@ -3273,16 +3273,16 @@ static void add_subsurf_node_limit_surface_option(Main &bmain)
 void blo_do_versions_400(FileData *fd, Library * /*lib*/, Main *bmain)
 {
   if (!MAIN_VERSION_FILE_ATLEAST(bmain, 400, 1)) {
-    LISTBASE_FOREACH (Mesh *, mesh, &bmain->meshes) {
-      version_mesh_legacy_to_struct_of_array_format(*mesh);
-    }
+    version_foreach_id_parallel(bmain->meshes, [](ID &id) {
+      version_mesh_legacy_to_struct_of_array_format(reinterpret_cast<Mesh &>(id));
+    });
     version_movieclips_legacy_camera_object(bmain);
   }
 
   if (!MAIN_VERSION_FILE_ATLEAST(bmain, 400, 2)) {
-    LISTBASE_FOREACH (Mesh *, mesh, &bmain->meshes) {
-      BKE_mesh_legacy_bevel_weight_to_generic(mesh);
-    }
+    version_foreach_id_parallel(bmain->meshes, [](ID &id) {
+      BKE_mesh_legacy_bevel_weight_to_generic(reinterpret_cast<Mesh *>(&id));
+    });
   }
 
   /* 400 4 did not require any do_version here. */
@@ -5185,9 +5185,9 @@ void blo_do_versions_400(FileData *fd, Library * /*lib*/, Main *bmain)
   /* Always run this versioning; meshes are written with the legacy format which always needs to
    * be converted to the new format on file load. Can be moved to a subversion check in a larger
    * breaking release. */
-  LISTBASE_FOREACH (Mesh *, mesh, &bmain->meshes) {
-    blender::bke::mesh_sculpt_mask_to_generic(*mesh);
-  }
+  version_foreach_id_parallel(bmain->meshes, [](ID &id) {
+    blender::bke::mesh_sculpt_mask_to_generic(reinterpret_cast<Mesh &>(id));
+  });
 
   /**
    * Always bump subversion in BKE_blender_version.h when adding versioning
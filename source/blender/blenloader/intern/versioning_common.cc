@@ -18,6 +18,8 @@
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
 #include "BLI_string_utf8.h"
+#include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #include "BKE_animsys.h"
 #include "BKE_grease_pencil_legacy_convert.hh"
@@ -612,6 +614,21 @@ static bool blendfile_or_libraries_versions_atleast(Main *bmain,
   return true;
 }
 
+void version_foreach_id_parallel(ListBase &ids, FunctionRef<void(ID &id)> fn)
+{
+  blender::Vector<ID *> ids_vector;
+  LISTBASE_FOREACH (ID *, id, &ids) {
+    ids_vector.append(id);
+  }
+  /* The amount of work per ID varies a lot (mesh sizes...), so use the smallest grain size. */
+  blender::threading::parallel_for(
+      ids_vector.index_range(), 1, [&](const blender::IndexRange range) {
+        for (const int i : range) {
+          fn(*ids_vector[i]);
+        }
+      });
+}
+
 void do_versions_after_setup(Main *new_bmain,
                              BlendfileLinkAppendContext *lapp_context,
                              BlendFileReadReport *reports)
@@ -184,3 +184,11 @@ void version_update_node_input(
     FunctionRef<void(bNode *, bNodeSocket *, bNode *, bNodeSocket *)> update_input_link);
 
 bNode *version_eevee_output_node_get(bNodeTree *ntree, int16_t node_type);
+
+/**
+ * Call \a fn for every ID of the \a ids list, in parallel.
+ *
+ * Only valid for versioning code that exclusively modifies data owned by each ID (e.g. mesh
+ * custom-data layers), and does not access other IDs or the #Main data-base.
+ */
+void version_foreach_id_parallel(ListBase &ids, FunctionRef<void(ID &id)> fn);
@@ -98,6 +98,7 @@
 #include "BLI_mempool.h"
 #include "BLI_set.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "MEM_guardedalloc.h" /* MEM_freeN */
 
@@ -144,7 +145,8 @@
 #define ZSTD_BUFFER_SIZE (1 << 21) /* 2mb */
 #define ZSTD_CHUNK_SIZE (1 << 20)  /* 1mb */
 
-#define ZSTD_COMPRESSION_LEVEL 3
+/** Used when #BlendFileWriteParams.compression_level is zero. */
+#define ZSTD_COMPRESSION_LEVEL_DEFAULT 3
 
 static CLG_LogRef LOG = {"blo.writefile"};
 
@@ -218,8 +220,25 @@ class ZstdWriteWrap : public WriteWrap {
 
   bool write_error = false;
 
+  /** Zstd compression level, see #BlendFileWriteParams.compression_level. */
+  int compression_level;
+  /** Number of compression threads, zero for automatic. */
+  int num_threads;
+
+  /**
+   * Compression contexts that are not in use by a task (protected by #mutex).
+   * Re-using contexts avoids allocating and initializing the (potentially large, depending on the
+   * compression level) internal zstd tables for every block.
+   */
+  blender::Vector<ZSTD_CCtx *> free_contexts;
+
  public:
-  ZstdWriteWrap(WriteWrap &base_wrap) : base_wrap(base_wrap) {}
+  ZstdWriteWrap(WriteWrap &base_wrap, const int level, const int threads_num)
+      : base_wrap(base_wrap),
+        compression_level(level ? level : ZSTD_COMPRESSION_LEVEL_DEFAULT),
+        num_threads(threads_num)
+  {
+  }
 
   bool open(const char *filepath) override;
   bool close() override;
@@ -228,6 +247,8 @@ class ZstdWriteWrap : public WriteWrap {
  private:
   struct ZstdWriteBlockTask;
   void write_task(ZstdWriteBlockTask *task);
+  ZSTD_CCtx *context_acquire();
+  void context_release(ZSTD_CCtx *ctx);
   void write_u32_le(uint32_t val);
   void write_seekable_frames();
 };
@@ -247,12 +268,33 @@ struct ZstdWriteWrap::ZstdWriteBlockTask {
   }
 };
 
+ZSTD_CCtx *ZstdWriteWrap::context_acquire()
+{
+  BLI_mutex_lock(&mutex);
+  ZSTD_CCtx *ctx = free_contexts.is_empty() ? nullptr : free_contexts.pop_last();
+  BLI_mutex_unlock(&mutex);
+
+  if (ctx == nullptr) {
+    ctx = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, compression_level);
+  }
+  return ctx;
+}
+
+void ZstdWriteWrap::context_release(ZSTD_CCtx *ctx)
+{
+  BLI_mutex_lock(&mutex);
+  free_contexts.append(ctx);
+  BLI_mutex_unlock(&mutex);
+}
+
 void ZstdWriteWrap::write_task(ZstdWriteBlockTask *task)
 {
   size_t out_buf_len = ZSTD_compressBound(task->size);
   void *out_buf = MEM_mallocN(out_buf_len, "Zstd out buffer");
-  size_t out_size = ZSTD_compress(
-      out_buf, out_buf_len, task->data, task->size, ZSTD_COMPRESSION_LEVEL);
+  ZSTD_CCtx *ctx = context_acquire();
+  size_t out_size = ZSTD_compress2(ctx, out_buf, out_buf_len, task->data, task->size);
+  context_release(ctx);
 
   MEM_freeN(task->data);
 
@@ -292,8 +334,11 @@ bool ZstdWriteWrap::open(const char *filepath)
     return false;
   }
 
-  /* Leave one thread open for the main writing logic, unless we only have one HW thread. */
-  int num_threads = max_ii(1, BLI_system_thread_count() - 1);
+  if (num_threads <= 0) {
+    /* Leave one thread open for the main writing logic, unless we only have one HW thread. */
+    num_threads = max_ii(1, BLI_system_thread_count() - 1);
+  }
+  num_threads = min_ii(num_threads, BLENDER_MAX_THREADS);
   BLI_threadpool_init(&threadpool, ZstdWriteBlockTask::write_task, num_threads);
   BLI_mutex_init(&mutex);
   BLI_condition_init(&condition);
@@ -350,6 +395,11 @@ bool ZstdWriteWrap::close()
   BLI_mutex_end(&mutex);
   BLI_condition_end(&condition);
 
+  for (ZSTD_CCtx *ctx : free_contexts) {
+    ZSTD_freeCCtx(ctx);
+  }
+  free_contexts.clear();
+
   write_seekable_frames();
   BLI_freelistN(&frames);
 
@@ -1747,7 +1797,7 @@ bool BLO_write_file(Main *mainvar,
   RawWriteWrap raw_wrap;
 
   if (write_flags & G_FILE_COMPRESS) {
-    ZstdWriteWrap zstd_wrap(raw_wrap);
+    ZstdWriteWrap zstd_wrap(raw_wrap, params->compression_level, params->compression_threads);
     return BLO_write_file_impl(mainvar, filepath, write_flags, params, reports, zstd_wrap);
   }
 
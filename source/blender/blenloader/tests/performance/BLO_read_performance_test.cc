@@ -0,0 +1,125 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include <cstdio>
+
+#include "BKE_appdir.hh"
+#include "BKE_collection.hh"
+#include "BKE_global.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_object.hh"
+#include "BKE_pointcloud.hh"
+#include "BKE_scene.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "BLI_string.h"
+#include "BLI_timeit.hh"
+
+#include "BLO_readfile.hh"
+#include "BLO_writefile.hh"
+
+#include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
+#include "DNA_scene_types.h"
+
+using namespace blender;
+
+class BlendfileReadPerformanceTest : public BlendfileLoadingBaseTest {
+ protected:
+  char filepath_[FILE_MAX] = "";
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    BKE_tempdir_init(nullptr);
+    BLI_path_join(filepath_, sizeof(filepath_), BKE_tempdir_session(), "read_performance.blend");
+  }
+
+  void TearDown() override
+  {
+    BLI_delete(filepath_, false, false);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  /**
+   * Write a synthetic file with `objects_num` point cloud objects of `points_num` points each,
+   * many small objects stress the ID handling, large point clouds stress reading array data.
+   */
+  void write_synthetic_file(const int objects_num, const int points_num, const bool use_compress)
+  {
+    Main *bmain = BKE_main_new();
+    Scene *scene = BKE_scene_add(bmain, "Scene");
+
+    for (const int i : IndexRange(objects_num)) {
+      PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+      BKE_libblock_management_main_add(bmain, pointcloud);
+      MutableSpan<float3> positions = pointcloud->positions_for_write();
+      for (const int point : positions.index_range()) {
+        positions[point] = float3(point, i, 0.0f);
+      }
+
+      char name[MAX_ID_NAME - 2];
+      SNPRINTF(name, "Object.%d", i);
+      Object *ob = BKE_object_add_only_object(bmain, OB_POINTCLOUD, name);
+      ob->data = pointcloud;
+      id_us_plus(&pointcloud->id);
+      BKE_collection_object_add(bmain, scene->master_collection, ob);
+    }
+
+    BlendFileWriteParams params{};
+    const int write_flags = use_compress ? G_FILE_COMPRESS : 0;
+    EXPECT_TRUE(BLO_write_file(bmain, filepath_, write_flags, &params, nullptr));
+    BKE_main_free(bmain);
+  }
+
+  void read_synthetic_file(const char *name)
+  {
+    BlendFileReadReport bf_reports{};
+    {
+      SCOPED_TIMER(name);
+      bfile = BLO_read_from_file(filepath_, BLO_READ_SKIP_NONE, &bf_reports);
+    }
+    ASSERT_NE(bfile, nullptr);
+
+    printf("  read data:  %.4fs (%+.2f MiB)\n",
+           bf_reports.duration.read_data,
+           double(bf_reports.memory.read_data) / (1024.0 * 1024.0));
+    printf("  versioning: %.4fs (%+.2f MiB)\n",
+           bf_reports.duration.versioning,
+           double(bf_reports.memory.versioning) / (1024.0 * 1024.0));
+    printf("  lib link:   %.4fs (%+.2f MiB)\n",
+           bf_reports.duration.lib_link,
+           double(bf_reports.memory.lib_link) / (1024.0 * 1024.0));
+
+    blendfile_free();
+  }
+};
+
+TEST_F(BlendfileReadPerformanceTest, many_small_ids)
+{
+  write_synthetic_file(20000, 16, false);
+  read_synthetic_file("many_small_ids");
+}
+
+TEST_F(BlendfileReadPerformanceTest, many_small_ids_compressed)
+{
+  write_synthetic_file(20000, 16, true);
+  read_synthetic_file("many_small_ids_compressed");
+}
+
+TEST_F(BlendfileReadPerformanceTest, large_arrays)
+{
+  write_synthetic_file(8, 4'000'000, false);
+  read_synthetic_file("large_arrays");
+}
+
+TEST_F(BlendfileReadPerformanceTest, large_arrays_compressed)
+{
+  write_synthetic_file(8, 4'000'000, true);
+  read_synthetic_file("large_arrays_compressed");
+}
@@ -13,6 +13,10 @@
 
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
+#include "BLI_path_utils.hh"
+#include "BLI_set.hh"
+#include "BLI_string.h"
+#include "BLI_vector.hh"
 
 #include "DNA_ID.h"
 #include "DNA_collection_types.h"
@@ -21,6 +25,7 @@
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
+#include "BKE_appdir.hh"
 #include "BKE_blender_undo.hh"
 #include "BKE_context.hh"
 #include "BKE_lib_query.hh"
@@ -70,6 +75,64 @@ static bool memfile_undosys_poll(bContext *C)
   return true;
 }
 
+/** Number of memfile steps on each side of the active one that are always kept in memory. */
+#define MEMFILE_UNDO_STEPS_IN_MEMORY 4
+
+/**
+ * Move memfile steps that are far away from \a us_keep (in both directions) to disk,
+ * so a deep undo history doesn't have to be kept in memory.
+ */
+static void memfile_undosys_spill_distant_steps(UndoStack *ustack, UndoStep *us_keep)
+{
+  if (!USER_EXPERIMENTAL_TEST(&U, use_undo_disk_spill) || us_keep == nullptr) {
+    return;
+  }
+
+  blender::Vector<MemFileUndoStep *> steps_to_spill;
+  for (const bool forward : {false, true}) {
+    int steps_num = 0;
+    for (UndoStep *us_iter = forward ? BKE_undosys_step_same_type_next(us_keep) :
+                                       BKE_undosys_step_same_type_prev(us_keep);
+         us_iter;
+         us_iter = forward ? BKE_undosys_step_same_type_next(us_iter) :
+                             BKE_undosys_step_same_type_prev(us_iter))
+    {
+      MemFileUndoStep *us = (MemFileUndoStep *)us_iter;
+      if (++steps_num > MEMFILE_UNDO_STEPS_IN_MEMORY && us->data->memfile.spill == nullptr) {
+        steps_to_spill.append(us);
+      }
+    }
+  }
+  if (steps_to_spill.is_empty()) {
+    return;
+  }
+
+  /* Buffers shared between steps must stay in memory. */
+  blender::Set<const char *> shared_buffers;
+  LISTBASE_FOREACH (UndoStep *, us_iter, &ustack->steps) {
+    if (us_iter->type != BKE_UNDOSYS_TYPE_MEMFILE) {
+      continue;
+    }
+    LISTBASE_FOREACH (MemFileChunk *, chunk, &((MemFileUndoStep *)us_iter)->data->memfile.chunks) {
+      if (chunk->is_identical) {
+        shared_buffers.add(chunk->buf);
+      }
+    }
+  }
+
+  static int spill_counter = 0;
+  for (MemFileUndoStep *us : steps_to_spill) {
+    char filename[64];
+    SNPRINTF(filename, "undo_%d.spill", spill_counter++);
+    char filepath[FILE_MAX];
+    BLI_path_join(filepath, sizeof(filepath), BKE_tempdir_session(), filename);
+
+    BLO_memfile_spill(&us->data->memfile, shared_buffers, filepath);
+    us->data->undo_size = us->data->memfile.size;
+    us->step.data_size = us->data->undo_size;
+  }
+}
+
 static bool memfile_undosys_step_encode(bContext * /*C*/, Main *bmain, UndoStep *us_p)
 {
   MemFileUndoStep *us = (MemFileUndoStep *)us_p;
@@ -86,6 +149,12 @@ static bool memfile_undosys_step_encode(bContext * /*C*/, Main *bmain, UndoStep
       ustack, BKE_UNDOSYS_TYPE_MEMFILE);
   us->data = BKE_memfile_undo_encode(bmain, us_prev ? us_prev->data : nullptr);
   us->step.data_size = us->data->undo_size;
+  if (us_prev) {
+    /* May have been loaded back from disk to be used as reference. */
+    us_prev->step.data_size = us_prev->data->undo_size;
+  }
+  /* The new step isn't part of the stack yet, the previous one is its closest neighbor. */
+  memfile_undosys_spill_distant_steps(ustack, us_prev ? &us_prev->step : nullptr);
 
   /* Store the fact that we should not re-use old data with that undo step, and reset the Main
    * flag. */
@@ -203,6 +272,8 @@ static void memfile_undosys_step_decode(
 
   MemFileUndoStep *us = (MemFileUndoStep *)us_p;
   BKE_memfile_undo_decode(us->data, undo_direction, use_old_bmain_data, C);
+  us_p->data_size = us->data->undo_size;
+  memfile_undosys_spill_distant_steps(ED_undo_stack_get(), us_p);
 
   for (UndoStep *us_iter = us_p->next; us_iter; us_iter = us_iter->next) {
     if (BKE_UNDOSYS_TYPE_IS_MEMFILE_SKIP(us_iter->type)) {
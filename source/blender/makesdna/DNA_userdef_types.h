@@ -747,6 +747,8 @@ typedef struct UserDef_Experimental {
   char use_all_linked_data_direct;
   char use_extensions_debug;
   char use_recompute_usercount_on_save_debug;
+  char use_blend_file_index;
+  char use_undo_disk_spill;
   char SANITIZE_AFTER_HERE;
   /* The following options are automatically sanitized (set to 0)
    * when the release cycle is not alpha. */
@@ -759,7 +761,7 @@ typedef struct UserDef_Experimental {
   char use_new_file_import_nodes;
   char use_shader_node_previews;
   char enable_new_cpu_compositor;
-  char _pad[4];
+  char _pad[2];
   /** `makesdna` does not allow empty structs. */
 } UserDef_Experimental;
 
@@ -847,14 +849,18 @@ typedef struct UserDef {
   short versions;
   short dbl_click_time;
 
-  char _pad0[3];
+  /** Zstd compression level for compressed .blend files. */
+  char file_compression_level;
+  char _pad0[2];
   char mini_axis_type;
   /** #eUserpref_UI_Flag. */
   int uiflag;
   /** #eUserpref_UI_Flag2. */
   char uiflag2;
   char gpu_flag;
-  char _pad8[6];
+  /** Number of threads used to compress .blend files, zero for automatic. */
+  short file_compression_threads;
+  char _pad8[4];
   /* Experimental flag for app-templates to make changes to behavior
    * which are outside the scope of typical preferences. */
   char app_flag;
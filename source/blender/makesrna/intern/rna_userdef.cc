@@ -23,6 +23,7 @@
 #include "BLI_memory_cache.hh"
 #include "BLI_string_utf8.h"
 #include "BLI_string_utf8_symbols.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 #ifdef WIN32
 #  include "BLI_winstuff.h"
@@ -7260,6 +7261,22 @@ static void rna_def_userdef_filepaths(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Compress File", "Enable file compression when saving .blend files");
 
+  prop = RNA_def_property(srna, "file_compression_level", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "file_compression_level");
+  RNA_def_property_range(prop, 1, 22);
+  RNA_def_property_ui_text(prop,
+                           "Compression Level",
+                           "Compression level used when saving compressed .blend files, "
+                           "higher levels result in smaller files but take longer to save");
+
+  prop = RNA_def_property(srna, "file_compression_threads", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "file_compression_threads");
+  RNA_def_property_range(prop, 0, BLENDER_MAX_THREADS);
+  RNA_def_property_ui_text(prop,
+                           "Compression Threads",
+                           "Number of threads used to compress .blend files while saving "
+                           "(0 uses all but one of the system threads)");
+
   prop = RNA_def_property(srna, "use_load_ui", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, nullptr, "flag", USER_FILENOUI);
   RNA_def_property_ui_text(prop, "Load UI", "Load user interface setup when loading .blend files");
@@ -7562,6 +7579,20 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
                            "completely reread assets from disk");
   RNA_def_property_update(prop, 0, "rna_userdef_ui_update");
 
+  prop = RNA_def_property(srna, "use_blend_file_index", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "use_blend_file_index", 1);
+  RNA_def_property_ui_text(prop,
+                           "Blend File Index",
+                           "Cache an index of the blocks of library files on disk, so that "
+                           "linking from them does not require scanning the whole file");
+
+  prop = RNA_def_property(srna, "use_undo_disk_spill", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "use_undo_disk_spill", 1);
+  RNA_def_property_ui_text(prop,
+                           "Undo Disk Spill",
+                           "Compress global undo steps far from the active one and move them to "
+                           "a temporary file, to keep a deep undo history with less memory");
+
   prop = RNA_def_property(srna, "use_viewport_debug", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "use_viewport_debug", 1);
   RNA_def_property_ui_text(prop,
@@ -975,6 +975,18 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
             duration_lib_override_recursive_resync_minutes,
             duration_lib_override_recursive_resync_seconds);
 
+  CLOG_INFO(&LOG,
+            0,
+            " * Phases: read data %.3fs (%+.2f MiB), versioning %.3fs (%+.2f MiB), lib link %.3fs "
+            "(%+.2f MiB), setup %.3fs",
+            bf_reports->duration.read_data,
+            double(bf_reports->memory.read_data) / (1024.0 * 1024.0),
+            bf_reports->duration.versioning,
+            double(bf_reports->memory.versioning) / (1024.0 * 1024.0),
+            bf_reports->duration.lib_link,
+            double(bf_reports->memory.lib_link) / (1024.0 * 1024.0),
+            bf_reports->duration.setup);
+
   if (bf_reports->resynced_lib_overrides_libraries_count != 0) {
     for (LinkNode *node_lib = bf_reports->resynced_lib_overrides_libraries; node_lib != nullptr;
          node_lib = node_lib->next)
@@ -1071,6 +1083,9 @@ bool WM_file_read(bContext *C, const char *filepath, ReportList *reports)
      * risk, because the excluded path list is also loaded. Further it's just confusing
      * if a user loads a file and various preferences change. */
     params.skip_flags = BLO_READ_SKIP_USERDEF;
+    if (G.f & G_FLAG_READFILE_USED_DATA_ONLY) {
+      params.skip_flags |= BLO_READ_SKIP_UNUSED_IDS;
+    }
 
     BlendFileReadReport bf_reports{};
     bf_reports.reports = reports;
@@ -1091,8 +1106,10 @@ bool WM_file_read(bContext *C, const char *filepath, ReportList *reports)
       const int G_f_orig = G.f;
 
       /* Frees the current main and replaces it with the new one read from file. */
+      bf_reports.duration.setup = BLI_time_now_seconds();
       BKE_blendfile_read_setup_readfile(
           C, bfd, &params, wm_setup_data, &bf_reports, false, nullptr);
+      bf_reports.duration.setup = BLI_time_now_seconds() - bf_reports.duration.setup;
       bmain = CTX_data_main(C);
 
       /* Finalize handling of WM, using the read WM and/or the current WM depending on things like
@@ -2085,6 +2102,13 @@ static bool wm_file_write_check_with_report_on_failure(Main *bmain,
     return false;
   }
 
+  if (bmain->is_partially_read) {
+    BKE_report(reports,
+               RPT_ERROR,
+               "Cannot save, only the data-blocks used by the active scene were loaded");
+    return false;
+  }
+
   if (bmain->is_asset_edit_file &&
       blender::StringRef(filepath).endswith(BLENDER_ASSET_FILE_SUFFIX))
   {
@@ -2209,6 +2233,8 @@ static bool wm_file_write(bContext *C,
   blend_write_params.remap_mode = remap_mode;
   blend_write_params.use_save_versions = true;
   blend_write_params.use_save_as_copy = use_save_as_copy;
+  blend_write_params.compression_level = U.file_compression_level;
+  blend_write_params.compression_threads = U.file_compression_threads;
   blend_write_params.thumb = thumb;
 
   const bool success = BLO_write_file(bmain, filepath, fileflags, &blend_write_params, reports);
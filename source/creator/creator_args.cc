@@ -789,6 +789,7 @@ static void print_help(bArgs *ba, bool all)
   BLI_args_print_arg_doc(ba, "--open-last");
   BLI_args_print_arg_doc(ba, "--app-template");
   BLI_args_print_arg_doc(ba, "--factory-startup");
+  BLI_args_print_arg_doc(ba, "--open-used-data-only");
   BLI_args_print_arg_doc(ba, "--enable-event-simulate");
   PRINT("\n");
   BLI_args_print_arg_doc(ba, "--env-system-datafiles");
@@ -1583,6 +1584,18 @@ static int arg_handle_factory_startup_set(int /*argc*/, const char ** /*argv*/,
   return 0;
 }
 
+static const char arg_handle_open_used_data_only_set_doc[] =
+    "\n\t"
+    "Only load the data-blocks used by the active scene (and the UI) when opening blend-files.\n"
+    "\tIntended for rendering and other read-only processing, saving these files is disabled.";
+static int arg_handle_open_used_data_only_set(int /*argc*/,
+                                              const char ** /*argv*/,
+                                              void * /*data*/)
+{
+  G.f |= G_FLAG_READFILE_USED_DATA_ONLY;
+  return 0;
+}
+
 static const char arg_handle_enable_event_simulate_doc[] =
     "\n\t"
     "Enable event simulation testing feature 'bpy.types.Window.event_simulate'.";
@@ -2814,6 +2827,8 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
 
   BLI_args_add(ba, nullptr, "--app-template", CB(arg_handle_app_template), nullptr);
   BLI_args_add(ba, nullptr, "--factory-startup", CB(arg_handle_factory_startup_set), nullptr);
+  BLI_args_add(
+      ba, nullptr, "--open-used-data-only", CB(arg_handle_open_used_data_only_set), nullptr);
   BLI_args_add(
       ba, nullptr, "--enable-event-simulate", CB(arg_handle_enable_event_simulate), nullptr);
 
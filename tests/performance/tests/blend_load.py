@@ -3,6 +3,13 @@
 # SPDX-License-Identifier: Apache-2.0
 
 import api
+import re
+
+# Per-phase timings and memory usage as logged by `wm.files` after a file has been read, e.g.
+# ` * Phases: read data 0.123s (+12.50 MiB), versioning 0.010s (+0.01 MiB), lib link ...`
+PHASES_PATTERN = re.compile(
+    r"\* Phases: read data ([0-9.]+)s \(([-+0-9.]+) MiB\), versioning ([0-9.]+)s \(([-+0-9.]+) MiB\), "
+    r"lib link ([0-9.]+)s \(([-+0-9.]+) MiB\), setup ([0-9.]+)s")
 
 
 def _run(filepath):
@@ -22,6 +29,24 @@ def _run(filepath):
     return result
 
 
+def _parse_phases(lines):
+    # The file is loaded twice, only keep the timings of the measured second load.
+    phases = {}
+    for line in lines:
+        match = PHASES_PATTERN.search(line)
+        if match:
+            phases = {
+                'read_data_time': float(match.group(1)),
+                'read_data_memory': float(match.group(2)) * 1024 * 1024,
+                'versioning_time': float(match.group(3)),
+                'versioning_memory': float(match.group(4)) * 1024 * 1024,
+                'lib_link_time': float(match.group(5)),
+                'lib_link_memory': float(match.group(6)) * 1024 * 1024,
+                'setup_time': float(match.group(7)),
+            }
+    return phases
+
+
 class BlendLoadTest(api.Test):
     def __init__(self, filepath):
         self.filepath = filepath
@@ -33,7 +58,8 @@ class BlendLoadTest(api.Test):
         return "blend_load"
 
     def run(self, env, device_id):
-        result, _ = env.run_in_blender(_run, str(self.filepath))
+        result, lines = env.run_in_blender(_run, str(self.filepath), ['--log', 'wm.files'])
+        result.update(_parse_phases(lines))
         return result
 
 
@@ -0,0 +1,43 @@
+# SPDX-FileCopyrightText: 2024 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+from .cycles import CyclesTest
+
+# Environment variables to force each CPU kernel variant, from widest to narrowest
+# instruction set. Variants not supported by the CPU fall back to the next one.
+KERNELS = {
+    'avx512': {},
+    'avx2': {'CYCLES_CPU_NO_AVX512': '1'},
+    'sse42': {'CYCLES_CPU_NO_AVX512': '1', 'CYCLES_CPU_NO_AVX2': '1'},
+}
+
+
+class CyclesCPUKernelTest(api.Test):
+    def __init__(self, filepath, kernel):
+        self.test = CyclesTest(filepath)
+        self.kernel = kernel
+
+    def name(self):
+        return f"{self.test.name()}_{self.kernel}"
+
+    def category(self):
+        return "cycles_cpu_kernels"
+
+    def use_device(self):
+        return False
+
+    def run(self, env, device_id):
+        environment = env.blender_executable_environment
+        env.blender_executable_environment = {**environment, **KERNELS[self.kernel]}
+        try:
+            return self.test.run(env, 'CPU')
+        finally:
+            env.blender_executable_environment = environment
+
+
+def generate(env):
+    filepaths = env.find_blend_files('cycles/*')
+    return [CyclesCPUKernelTest(filepath, kernel) for filepath in filepaths for kernel in KERNELS]